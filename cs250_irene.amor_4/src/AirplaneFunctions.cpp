@@ -1,6 +1,59 @@
 
 #include "AirplaneFunctions.h"  //Header file
 #include <vector>               //For the vector of m2w matrices
+#include <cmath>                //cosf, sinf
+#include <cstring>              //strcmp
+#include <unordered_map>        //Objects by name
+#include <atomic>               //Pixels shaded by every band
+#include <algorithm>            //partial_sort, sort, fill
+#include <numeric>              //iota
+
+constexpr double Airplane::TICK;
+
+namespace
+{
+    //Tile of every thread, only used while the thread draws one tile
+    struct Tile
+    {
+        ~Tile() { FrameBuffer::Release(buffer); }
+
+        FrameBuffer::Buffer buffer;
+        int                 size = 0;
+    };
+
+    thread_local Tile tile;
+
+    /**
+    * @brief CameraInModel: position of the camera in the space of a mesh
+    *
+    * @param model_view:    model to camera of the mesh, the camera is at its origin
+    * @return               point the matrix takes to the origin
+    */
+    Point4 CameraInModel(const Matrix4& model_view)
+    {
+        //Solve A * p + t = 0 for the 3x3 part A and the translation t (Cramer's rule)
+        const float (*m)[4] = model_view.m;
+        float det = m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
+                    m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+                    m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+
+        Point4 eye;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            //The column of the axis replaced by -t
+            float a[3][3];
+            for (int row = 0; row < 3; row++)
+                for (int col = 0; col < 3; col++)
+                    a[row][col] = col == axis ? -m[row][3] : m[row][col];
+
+            eye.v[axis] = (a[0][0] * (a[1][1] * a[2][2] - a[1][2] * a[2][1]) -
+                           a[0][1] * (a[1][0] * a[2][2] - a[1][2] * a[2][0]) +
+                           a[0][2] * (a[1][0] * a[2][1] - a[1][1] * a[2][0])) / det;
+        }
+        eye.w = 1.f;
+        return eye;
+    }
+}
 
 
 
@@ -15,26 +68,86 @@ void Airplane::Airplane_Initialize()
     parser = new CS250Parser;
     parser->LoadDataFromFile("input.txt");
 
+    //Object count, hierarchy and mesh
+    UpdateSceneInfo();
+
     //Set viewport size
     view_width = parser->right - parser->left;
     view_height = parser->top - parser->bottom;
 
-    //Number of faces per cube and number of vertices per face
-    max_faces = parser->faces.size();
-    TOTAL_obj = parser->objects.size();
-
-    //Get view and perspective matrices
-    Viewport_Transformation();
-    Perspective_Transform();
+    //The views get their viewport and perspective matrices on the first frame
 
     //Start scene with the rooted camera
     camera_persp = rooted;
     RootedCamera();
     draw_mode = solid;
+}
 
 
+/**
+* @brief UpdateSceneInfo:   find the parent of every object and the airplane body and
+*                           prepare the mesh, needs to be called again if the scene objects
+*                           or the mesh change
+*
+* @param (void)
+*/
+void Airplane::UpdateSceneInfo()
+{
+    TOTAL_obj = parser->objects.size();
+
+    //Index of every object by name, the first one wins as in FindObject
+    std::unordered_map<std::string, int> names;
+    names.reserve(TOTAL_obj);
+    for (int obj = 0; obj < TOTAL_obj; obj++)
+        names.emplace(parser->objects[obj].name, obj);
+
+    //Index of the parent of every object, -1 for none
+    parents.resize(TOTAL_obj);
+    for (int obj = 0; obj < TOTAL_obj; obj++)
+    {
+        auto parent = names.find(parser->objects[obj].parent);
+        parents[obj] = parent != names.end() ? parent->second : -1;
+    }
+
+    auto body = names.find("body");
+    body_index = body != names.end() ? body->second : -1;
+
+    //Objects that never move: the input only moves the body, and the rotation of every
+    //object is applied again every step. Only the ones without either, up to the root
+    static_objects.clear();
+    dynamic_objects.clear();
+    for (int obj = 0; obj < TOTAL_obj; obj++)
+    {
+        bool fixed = true;
+        for (int node = obj; node >= 0 && fixed; node = parents[node])
+        {
+            const Vector4& rot = parser->objects[node].rot;
+            fixed = node != body_index && rot.x == 0.f && rot.y == 0.f && rot.z == 0.f;
+        }
+
+        if (fixed)
+            static_objects.push_back(obj);
+        else
+            dynamic_objects.push_back(obj);
+    }
+
+    //Their transforms once for the whole scene, every one on its own first as in Tick.
+    //The parents of a static object are static, so they are ready when it needs them
+    Matrix4 identity;
+    identity.Identity();
+    static_m2w.assign(TOTAL_obj, identity);
+    for (int obj : static_objects)
+        static_m2w[obj] = LocalTransform(obj, true);
+    for (int obj : static_objects)
+        static_m2w[obj] = ModelToWorld(obj, static_m2w[obj]);
+    scene_version++;
+
+    //Number of faces per cube and number of vertices per face
+    max_faces = parser->faces.size();
+
     //Get the color of each face
     //They are the same for all the cubes
+    color.resize(max_faces);
     for (int j = 0; j < max_faces; j++)
     {
         //Normalize color
@@ -44,104 +157,1043 @@ void Airplane::Airplane_Initialize()
         color[j].b = color[j].b / 255;
     }
 
-}
+    //Simpler versions of the mesh for the objects far away, all of them split into clusters
+    Lod::Build(lods, parser->vertices, parser->faces);
+    max_clusters = 0;
+    for (const Lod::Mesh& level : lods.levels)
+        max_clusters = std::max(max_clusters, static_cast<int>(level.meshlets.clusters.size()));
 
+    //The hierarchy and the world vertices are made again for the new objects and mesh
+    bvh_m2w.clear();
+    static_batch.first_vertex.clear();
+}
 
 /**
-* @brief Airplane_Update: renders the current state of the airplane
+* @brief Airplane_Update: simulates and renders the next frame of the airplane
 *
 * @param (void)
 */
 void Airplane::Airplane_Update()
+{
+    Simulate(snapshot);
+    Render(snapshot);
+}
+
+/**
+* @brief Simulate:  steps the simulation up to the time of the next frame and
+*                   saves what the renderer needs from it, interpolated between
+*                   the last two steps so the motion does not depend on the frame rate
+*
+* @param out:       snapshot of the frame, it can be rendered while the next frame is simulated
+* @param elapsed:   seconds since the last frame, a step by default
+*/
+void Airplane::Simulate(Snapshot& out, double elapsed)
+{
+    frame_time += elapsed;
+
+    //Fixed steps until the simulation reaches the frame, at least one for the first frame
+    for (int ticks = 0; simulated_time < frame_time || tick_count == 0; ticks++)
+    {
+        //Too far behind to catch up, slow down instead of taking longer every frame
+        if (ticks == MAX_TICKS)
+        {
+            frame_time = simulated_time;
+            break;
+        }
+
+        Tick();
+        simulated_time += TICK;
+    }
+
+    //How far the frame is from the step before the last one to the last one
+    float t = 1.f - static_cast<float>((simulated_time - frame_time) / TICK);
+
+    out.views       = view_layout == single ? 1 : MAX_VIEWS;
+    out.view_layout = view_layout;
+
+    {
+        PROFILE_SCOPE(model_to_world);
+
+        //The static objects only once per scene, they are the same in every step
+        if (out.scene != current_scene)
+        {
+            out.m2w   = current_m2w;
+            out.scene = current_scene;
+        }
+
+        if (cut || t >= 1.f)
+        {
+            for (int obj : dynamic_objects)
+                out.m2w[obj] = current_m2w[obj];
+            for (int view = 0; view < out.views; view++)
+                out.w2c[view] = current_w2c[view];
+        }
+        else
+        {
+            for (int obj : dynamic_objects)
+                out.m2w[obj] = previous_m2w[obj] * (1.f - t) + current_m2w[obj] * t;
+
+            for (int view = 0; view < out.views; view++)
+                out.w2c[view] = previous_w2c[view] * (1.f - t) + current_w2c[view] * t;
+        }
+    }
+
+    out.draw_mode = draw_mode;
+}
+
+/**
+* @brief Tick:  moves the airplane and the camera by one fixed step
+*
+* @param (void)
+*/
+void Airplane::Tick()
 {
     //Get inputs from the user
-    draw_mode = GetInput();
-  
-    std::vector<Matrix4> m2w;
+    {
+        PROFILE_SCOPE(input);
+        draw_mode = GetInput();
+    }
 
 
     //Need to calculate the model to world matrix before calculating the cameras
     //to get the model to world matrices that get multiplied by the scale
     //This is done to avoid 
-    for (int obj = 0; obj < TOTAL_obj; obj++)
     {
-        m2w.push_back(ModelToWorld(parser->objects[obj], true));
-    }
+        PROFILE_SCOPE(model_to_world);
+        previous_m2w.swap(current_m2w);
+        std::swap(previous_scene, current_scene);
 
+        //The static objects keep the transforms they got with the scene
+        if (current_scene != scene_version)
+        {
+            current_m2w   = static_m2w;
+            current_scene = scene_version;
+        }
 
-    //Calculate the current camera (sets the w2c matrix)
-    if (camera_persp == first)
-        FirstPersonCamera();
-    else if (camera_persp == third)
-        ThirdPersonCamera();
+        //Every dynamic object on its own first, then with its parents once all of them are updated
+        auto local = [this](int first, int last)
+        {
+            for (int i = first; i < last; i++)
+                current_m2w[dynamic_objects[i]] = LocalTransform(dynamic_objects[i], true);
+        };
+        auto world = [this](int first, int last)
+        {
+            for (int i = first; i < last; i++)
+                current_m2w[dynamic_objects[i]] = ModelToWorld(dynamic_objects[i], current_m2w[dynamic_objects[i]]);
+        };
+
+        const int dynamic = static_cast<int>(dynamic_objects.size());
+        JobSystem::Counter locals, worlds;
+        JobSystem::ParallelFor(0, dynamic, OBJECT_GRAIN, local, locals);
+        JobSystem::ParallelFor(0, dynamic, OBJECT_GRAIN, world, worlds, &locals);
+        JobSystem::Wait(worlds);
+    }
 
 
-    //Calculate and draw the vertices
-    for (int obj = 0; obj < TOTAL_obj; obj++)
+    //Calculate the camera of every view, the main one the last so the camera
+    //information is left as the one of the main camera
     {
-        //Vertices of the cube
-        for (int i = 0; i < max_faces; i++)
+        PROFILE_SCOPE(camera);
+        int count = view_layout == single ? 1 : MAX_VIEWS;
+
+        for (int view = count - 1; view >= 0; view--)
         {
-            auto face = parser->faces[i];
-            Rasterizer::Vertex vtx[3];      //Each vertex of the triangle
-            bool draw = true;
+            previous_w2c[view] = current_w2c[view];
+            current_w2c[view]  = CameraMatrix(ViewCamera(view));
+        }
+
+        tick_count++;
+    }
+
+    //A new camera, layout or scene jumps instead of moving from the last step
+    cut = camera_persp != tick_camera || view_layout != tick_layout ||
+          previous_scene != current_scene;
+    tick_camera = camera_persp;
+    tick_layout = view_layout;
+}
+
+/**
+* @brief Render:    draws a simulated frame, it does not change the airplane
+*                   so it can run at the same time as Simulate
+*
+* @param frame:     snapshot of the frame
+*/
+void Airplane::Render(const Snapshot& frame)
+{
+    //Counters of this frame
+    Rasterizer::ResetStats();
+    FrameBuffer::EnableOverdraw(frame.draw_mode == overdraw);
+
+    if (frame.view_layout != views_layout)
+        SetupViews(frame.view_layout);
+
+    //The views query the hierarchy at the same time, it is made right for this frame first
+    if (frustum_culling)
+        UpdateBvh(frame.m2w);
 
-            //Calculate the vertices
-            for (int j = 0; j < 3; j++)
+    //The world vertices of the static objects, once per scene
+    if (static_batching && static_batch.first_vertex.size() != frame.m2w.size())
+    {
+        PROFILE_SCOPE(vertex);
+        StaticBatch::Build(static_batch, parser->vertices, frame.m2w, static_objects);
+    }
+
+    //Every view on its own thread, the insets of the picture in picture go over the main view.
+    //The thread of each view draws to the buffer bound on this one
+    FrameBuffer::Buffer& target = FrameBuffer::GetBound();
+    auto draw = [this, &frame, &target](int first, int last)
+    {
+        FrameBuffer::Buffer& previous = FrameBuffer::GetBound();
+        FrameBuffer::Bind(target);
+
+        for (int view = first; view < last; view++)
+            DrawView(frame, view);
+
+        FrameBuffer::Bind(previous);
+    };
+
+    if (frame.views == 1)
+        draw(0, 1);
+    else if (frame.view_layout == picture_in_picture)
+    {
+        JobSystem::Counter main_view, insets;
+        JobSystem::ParallelFor(0, 1, 1, draw, main_view);
+        JobSystem::ParallelFor(1, frame.views, 1, draw, insets, &main_view);
+        JobSystem::Wait(insets);
+        JobSystem::Wait(main_view);
+    }
+    else
+        JobSystem::ParallelFor(0, frame.views, 1, draw);
+
+    for (int view = 0; view < frame.views; view++)
+        Rasterizer::AddStats(views[view].stats);
+
+    //Show the writes to every pixel instead of the colors
+    if (frame.draw_mode == overdraw)
+    {
+        PROFILE_SCOPE(raster);
+        FrameBuffer::ResolveOverdraw();
+    }
+}
+
+/**
+* @brief DrawView:  draws the objects of a frame from the camera of one view,
+*                   the views of a frame can be drawn at the same time
+*
+* @param frame:     snapshot of the frame
+* @param index:     view to draw
+*/
+void Airplane::DrawView(const Snapshot& frame, int index)
+{
+    View& view = views[index];
+    const std::vector<Matrix4>& m2w = frame.m2w;
+    const Matrix4& w2c = frame.w2c[index];
+    const int objects = static_cast<int>(m2w.size());
+
+    //The counters of the view are kept apart from whatever else this thread draws
+    Rasterizer::Stats thread_stats = Rasterizer::stats;
+    Rasterizer::ResetStats();
+
+    //An inset covers part of the main view
+    if (index > 0 && frame.view_layout == picture_in_picture)
+        FrameBuffer::Clear(view.x, view.y, view.width, view.height, 255, 255, 255);
+
+
+    //Frustum of the view widened by two pixels, the lines round to the closest pixel
+    const float x_limit = 0.5f + 2.f / view.width;
+    const float y_limit = 0.5f + 2.f / view.height;
+
+    //Objects that can be seen: the ones whose world boxes touch the frustum, or all of them
+    if (frustum_culling)
+    {
+        PROFILE_SCOPE(frustum);
+
+        view.objects.clear();
+        Bvh::Query(bvh, Bvh::FrustumPlanes(view.projection * w2c, x_limit, y_limit, parser->nearPlane), view.objects);
+
+        //The objects are drawn in the same order as without the hierarchy
+        std::sort(view.objects.begin(), view.objects.end());
+    }
+    else
+    {
+        view.objects.resize(objects);
+        std::iota(view.objects.begin(), view.objects.end(), 0);
+    }
+    const int count = static_cast<int>(view.objects.size());
+
+
+    //Calculate the vertices of every object, every vertex of the mesh only once.
+    //Everything of the view from here on is by position in its list of objects.
+    //Every object has room for the vertices of the full mesh, whatever its level
+    const int mesh_vertices = static_cast<int>(parser->vertices.size());
+    {
+        PROFILE_SCOPE(vertex);
+        view.vertices.resize(count * mesh_vertices);
+        view.behind.resize(count * mesh_vertices);
+        view.bounds.resize(count);
+        view.levels.resize(count);
+        view.draws.resize(count);
+        if (meshlet_culling)
+            view.clusters.resize(count * max_clusters);
+
+        //Screen pixels of a unit of the camera at a distance of one unit
+        const float pixels_per_unit = std::fmax(std::fabs(view.width * view.projection.m[0][0]),
+                                                std::fabs(view.height * view.projection.m[1][1]));
+
+        //Perspective and camera of the view, the only transform of the world vertices
+        const Matrix4 view_projection = view.projection * w2c;
+
+        JobSystem::ParallelFor(0, count, OBJECT_GRAIN, [this, &frame, &view, &m2w, &w2c, &view_projection, mesh_vertices, pixels_per_unit, x_limit, y_limit](int first, int last)
+        {
+            for (int i = first; i < last; i++)
             {
-                //Get vertices: color
-                vtx[j].color = color[i];
+                const int obj = view.objects[i];
 
-                //Get vertices: position
-                vtx[j].position = parser->vertices[face.indices[j]];
+                //Distance from the camera to the center of the object, it looks down -z
+                Point4 center = w2c * m2w[obj] * Point4(0.f, 0.f, 0.f);
+                view.draws[i].key    = draw_order == front_to_back ? DrawList::DepthKey(-center.z) : 0;
+                view.draws[i].object = i;
 
-                //Transform vertices: perspective division and model to world (using the m2w with the scale)
-                vtx[j].position = persp_transf * w2c * m2w[obj] * vtx[j].position;
+                //Level of detail from the size of the sphere around the object on the screen,
+                //measured at its nearest point. Only if all of it is in front of the camera
+                int level = 0;
+                if (level_of_detail)
+                {
+                    Matrix4 model_view = w2c * m2w[obj];
+                    float scale = 0.f;
+                    for (int axis = 0; axis < 3; axis++)
+                        scale = std::fmax(scale, std::sqrt(model_view.m[0][axis] * model_view.m[0][axis] +
+                                                           model_view.m[1][axis] * model_view.m[1][axis] +
+                                                           model_view.m[2][axis] * model_view.m[2][axis]));
+
+                    Point4 sphere  = model_view * lods.center;
+                    float  nearest = -sphere.z - lods.radius * scale;
+                    if (nearest >= parser->nearPlane)
+                    {
+                        float pixels = pixels_per_unit * scale / nearest;
+                        level = 2.f * lods.radius * pixels < MIN_OBJECT_PIXELS ? -1 : Lod::Select(lods, pixels, LOD_ERROR);
+                    }
+                }
+                view.levels[i] = level;
 
-                //Culling: don't draw objects behind the camera
-                if (vtx[j].position.z < -parser->nearPlane)
+                //Too small to be seen: nothing to transform
+                Bounds& bounds = view.bounds[i];
+                bounds.hidden = false;
+                if (level < 0)
                 {
-                    draw = false;
-                    break;
+                    bounds.testable = false;
+                    continue;
                 }
-            
-                //Transform vertices: perspective division
-                vtx[j].position.x = vtx[j].position.x / vtx[j].position.w;
-                vtx[j].position.y = vtx[j].position.y / vtx[j].position.w;
-                vtx[j].position.z = vtx[j].position.z / vtx[j].position.w;
-                vtx[j].position.w = vtx[j].position.w / vtx[j].position.w;
-
-                //Transform vertices: view transformation
-                vtx[j].position = viewport * vtx[j].position;
+                const Lod::Mesh& mesh = lods.levels[level];
+
+                //Perspective division and model to world (using the m2w with the scale). The
+                //full mesh of a static object is already in the world, only the view is left
+                const bool batched = static_batching && level == 0 && static_batch.first_vertex[obj] >= 0;
+                const Point4* source = batched ? &static_batch.vertices[static_batch.first_vertex[obj]] : mesh.vertices.data();
+                Matrix4 transform = batched ? view_projection : view.projection * w2c * m2w[obj];
+                bounds.testable = true;
+                bounds.whole    = true;
+
+                //Clusters outside of the frustum or turned away from the camera, both
+                //tested in the space of the mesh before any of their vertices is transformed.
+                //The wireframe shows the back edges, only the frustum is tested there
+                unsigned char* cluster_states = meshlet_culling ? &view.clusters[i * max_clusters] : nullptr;
+                if (meshlet_culling)
+                {
+                    Bvh::Frustum frustum = Bvh::FrustumPlanes(batched ? view.projection * w2c * m2w[obj] : transform,
+                                                              x_limit, y_limit, parser->nearPlane);
+                    Point4 eye = CameraInModel(w2c * m2w[obj]);
+
+                    for (size_t c = 0; c < mesh.meshlets.clusters.size(); c++)
+                    {
+                        const Meshlet::Cluster& cluster = mesh.meshlets.clusters[c];
+                        if (Meshlet::Outside(cluster, frustum))
+                            cluster_states[c] = occluded_triangle;
+                        else if (frame.draw_mode != wireframe && Meshlet::FacesAway(cluster, eye))
+                            cluster_states[c] = culled_triangle;
+                        else
+                            cluster_states[c] = drawn_triangle;
+
+                        bounds.whole = bounds.whole && cluster_states[c] == drawn_triangle;
+                    }
+                }
+
+                bool empty = true;
+                auto project = [this, &view, &bounds, &transform, source, &empty, i, mesh_vertices](int v)
+                {
+                    Point4& position = view.vertices[i * mesh_vertices + v];
+                    position = transform * source[v];
+
+                    //Culling: the triangles with vertices behind the camera are not drawn
+                    view.behind[i * mesh_vertices + v] = position.z < -parser->nearPlane;
+                    bounds.testable = bounds.testable && !view.behind[i * mesh_vertices + v];
+
+                    //Transform vertices: perspective division
+                    position.x = position.x / position.w;
+                    position.y = position.y / position.w;
+                    position.z = position.z / position.w;
+                    position.w = position.w / position.w;
+
+                    //Transform vertices: view transformation
+                    position = view.viewport * position;
+
+                    //Rectangle and depth range of the object on the screen
+                    if (empty)
+                    {
+                        bounds.left = bounds.right = position.x;
+                        bounds.top = bounds.bottom = position.y;
+                        bounds.near_z = bounds.far_z = position.z;
+                        empty = false;
+                    }
+                    bounds.left   = std::fmin(bounds.left, position.x);
+                    bounds.right  = std::fmax(bounds.right, position.x);
+                    bounds.top    = std::fmin(bounds.top, position.y);
+                    bounds.bottom = std::fmax(bounds.bottom, position.y);
+                    bounds.near_z = std::fmin(bounds.near_z, position.z);
+                    bounds.far_z  = std::fmax(bounds.far_z, position.z);
+                };
+
+                //Every vertex, or the ones of the clusters left. A vertex shared by some
+                //clusters is only projected by the first one, the others find it done
+                if (bounds.whole)
+                {
+                    for (int v = 0; v < static_cast<int>(mesh.vertices.size()); v++)
+                        project(v);
+                }
+                else
+                {
+                    const unsigned char not_projected = 2;
+                    unsigned char* behind = &view.behind[i * mesh_vertices];
+                    std::fill(behind, behind + mesh.vertices.size(), not_projected);
+
+                    for (size_t c = 0; c < mesh.meshlets.clusters.size(); c++)
+                    {
+                        const Meshlet::Cluster& cluster = mesh.meshlets.clusters[c];
+                        if (cluster_states[c] != drawn_triangle)
+                            continue;
+
+                        for (int v = 0; v < cluster.vertices; v++)
+                        {
+                            int vertex = mesh.meshlets.vertices[cluster.first_vertex + v];
+                            if (behind[vertex] == not_projected)
+                                project(vertex);
+                        }
+                    }
+                }
+
+                //Nothing left to draw
+                bounds.testable = bounds.testable && !empty;
+
+                //The bounds of an object across the camera plane are not right
+                bounds.testable = bounds.testable && std::isfinite(bounds.left + bounds.right + bounds.top + bounds.bottom);
             }
+        });
+    }
+
+
+    //Skip the objects that are completely behind the large objects near the camera.
+    //The lines of the wireframe do not hide anything
+    if (occlusion_culling && frame.draw_mode != wireframe)
+        CullOccluded(view, mesh_vertices);
 
-            //Draw the object
-            if (draw)
+
+    //The vertices of every triangle of the objects that can be seen
+    //Every triangle has its own slot, so the objects can be done on any thread
+    //and the triangles are still drawn in the same order
+    const int slots = count * static_cast<int>(max_faces);
+    std::vector<Rasterizer::Vertex>& triangles = view.triangles;
+    std::vector<unsigned char>& triangle_states = view.triangle_states;
+    {
+        PROFILE_SCOPE(vertex);
+        triangles.resize(3 * slots);
+        triangle_states.resize(slots);
+        if (tile_size > 0)
+            view.boxes.resize(slots);
+
+        JobSystem::ParallelFor(0, count, OBJECT_GRAIN, [this, &frame, &view, mesh_vertices](int first, int last)
+        {
+            for (int obj = first; obj < last; obj++)
             {
-                if (draw_mode == depth_buffer)
+                //Faces of the level of the object, the slots after them stay empty
+                const int level = view.levels[obj];
+                const int faces = level < 0 ? 0 : static_cast<int>(lods.levels[level].faces.size());
+                const unsigned char* cluster_states = meshlet_culling ? &view.clusters[obj * max_clusters] : nullptr;
+
+                //Vertices of the cube
+                for (int i = 0; i < max_faces; i++)
                 {
+                    int slot = obj * static_cast<int>(max_faces) + i;
+                    Rasterizer::Vertex* vtx = &view.triangles[3 * slot];    //Each vertex of the triangle
+                    bool draw = true;
+                    bool clipped = false;
+
+                    if (view.bounds[obj].hidden)
+                    {
+                        view.triangle_states[slot] = occluded_triangle;
+                        continue;
+                    }
+
+                    if (i >= faces)
+                    {
+                        view.triangle_states[slot] = simplified_triangle;
+                        continue;
+                    }
+                    const Lod::Mesh& mesh = lods.levels[level];
+                    auto face = mesh.faces[i];
+
+                    //The whole cluster of the face was skipped
+                    if (cluster_states && cluster_states[mesh.meshlets.cluster_of[i]] != drawn_triangle)
+                    {
+                        view.triangle_states[slot] = cluster_states[mesh.meshlets.cluster_of[i]];
+                        continue;
+                    }
+
+                    //Get the vertices
                     for (int j = 0; j < 3; j++)
                     {
-                        vtx[j].color.r = (vtx[j].position.z + 1) * 0.5f;
-                        vtx[j].color.g = (vtx[j].position.z + 1) * 0.5f;
-                        vtx[j].color.b = (vtx[j].position.z + 1) * 0.5f;
+                        int vertex = obj * mesh_vertices + face.indices[j];
+
+                        //Culling: don't draw objects behind the camera
+                        if (view.behind[vertex])
+                        {
+                            draw = false;
+                            break;
+                        }
+
+                        vtx[j].color    = color[mesh.colors[i]];
+                        vtx[j].position = view.vertices[vertex];
+
+                        //Partially outside of the view: the pixels outside get discarded
+                        if (vtx[j].position.x < view.x || vtx[j].position.x >= view.x + view.width ||
+                            vtx[j].position.y < view.y || vtx[j].position.y >= view.y + view.height)
+                            clipped = true;
+                    }
+
+                    if (!draw)
+                    {
+                        view.triangle_states[slot] = culled_triangle;
+                        continue;
+                    }
+
+                    view.triangle_states[slot] = clipped ? clipped_triangle : drawn_triangle;
+
+                    //The pixels it can touch, for the bins of the tiles, while its vertices are in the cache
+                    if (tile_size > 0)
+                    {
+                        float min_x = vtx[0].position.x, max_x = min_x;
+                        float min_y = vtx[0].position.y, max_y = min_y;
+                        for (int j = 1; j < 3; j++)
+                        {
+                            const Point4& position = vtx[j].position;
+                            min_x = position.x < min_x ? position.x : min_x;
+                            max_x = position.x > max_x ? position.x : max_x;
+                            min_y = position.y < min_y ? position.y : min_y;
+                            max_y = position.y > max_y ? position.y : max_y;
+                        }
+
+                        //The rasterizer rounds toward zero, a line can end up to 1.5 pixels right of
+                        //its vertex and the last pixel of a span to 1 pixel, so the box is bigger.
+                        //It is clamped to one pixel around the view, where the casts round down,
+                        //so a triangle outside of the view gets an empty box. The filled triangles
+                        //without any row of pixels draw nothing, most of the tiny ones are like that
+                        PixelBox& box = view.boxes[slot];
+                        if (frame.draw_mode != wireframe && Rasterizer::CoversNoRow(min_y, max_y))
+                            box = {1, 0, 0, 0};
+                        else
+                        {
+                            auto clamp = [](float value, int low, int high)
+                            {
+                                return static_cast<short>(value >= low ? (value <= high ? value : high) : low);
+                            };
+                            box.left   = clamp(min_x - 1.f, view.x, view.x + view.width);
+                            box.top    = clamp(min_y - 1.f, view.y, view.y + view.height);
+                            box.right  = clamp(max_x + 2.f, view.x - 1, view.x + view.width - 1);
+                            box.bottom = clamp(max_y + 2.f, view.y - 1, view.y + view.height - 1);
+                        }
                     }
 
-                    Rasterizer::DrawTriangleSolid(vtx[0], vtx[1], vtx[2]);
+                    //The depth is drawn as the color
+                    if (frame.draw_mode == depth_buffer)
+                    {
+                        for (int j = 0; j < 3; j++)
+                        {
+                            vtx[j].color.r = (vtx[j].position.z + 1) * 0.5f;
+                            vtx[j].color.g = (vtx[j].position.z + 1) * 0.5f;
+                            vtx[j].color.b = (vtx[j].position.z + 1) * 0.5f;
+                        }
+                    }
                 }
-                else if (draw_mode == solid)
-                    Rasterizer::DrawTriangleSolid(vtx[0], vtx[1], vtx[2]);
-                else
+            }
+        });
+
+        //Counters of the triangles, on this thread only. The objects outside of the frustum
+        //are counted with the hidden ones
+        Rasterizer::stats.triangles_submitted += objects * static_cast<int>(max_faces);
+        Rasterizer::stats.triangles_occluded  += (objects - count) * static_cast<int>(max_faces);
+        for (int slot = 0; slot < slots; slot++)
+        {
+            if (triangle_states[slot] == culled_triangle)
+                Rasterizer::stats.triangles_culled++;
+            else if (triangle_states[slot] == occluded_triangle)
+                Rasterizer::stats.triangles_occluded++;
+            else if (triangle_states[slot] == simplified_triangle)
+                Rasterizer::stats.triangles_simplified++;
+            else if (triangle_states[slot] == clipped_triangle)
+                Rasterizer::stats.triangles_clipped++;
+        }
+    }
+
+
+    //Triangles in drawing order: the nearest objects first, so most pixels
+    //of the objects behind them fail the depth test
+    {
+        PROFILE_SCOPE(sort);
+
+        if (draw_order == front_to_back)
+            DrawList::Sort(view.draws, view.draws_scratch);
+
+        view.slots.clear();
+        for (const DrawList::Draw& draw : view.draws)
+        {
+            for (int face = 0; face < static_cast<int>(max_faces); face++)
+            {
+                int slot = draw.object * static_cast<int>(max_faces) + face;
+                if (triangle_states[slot] == drawn_triangle || triangle_states[slot] == clipped_triangle)
+                    view.slots.push_back(slot);
+            }
+        }
+    }
+
+
+    //Draw the triangles, only inside of the view
+    const bool prepass = shading_mode == depth_prepass && frame.draw_mode != wireframe;
+    if (tile_size > 0)
+        DrawTiles(frame, view);
+    else
+    {
+        FrameBuffer::SetScissor(view.x, view.y, view.width, view.height);
+
+        //The final depth of every pixel first, so the colors are only written once
+        if (prepass)
+        {
+            PROFILE_SCOPE(prepass);
+
+            for (int slot : view.slots)
+                DrawTriangle(frame.draw_mode, &triangles[3 * slot], slot + 1, true);
+        }
+
+        PROFILE_SCOPE(raster);
+        for (int slot : view.slots)
+            DrawTriangle(frame.draw_mode, &triangles[3 * slot], slot + 1);
+
+        FrameBuffer::ResetScissor();
+    }
+
+    //Color every visible pixel once, in bands of rows on any thread
+    if (shading_mode == visibility && frame.draw_mode != wireframe && tile_size == 0)
+    {
+        PROFILE_SCOPE(shade);
+
+        FrameBuffer::Buffer& target = FrameBuffer::GetBound();
+        std::atomic<unsigned long long> shaded(0);
+        JobSystem::ParallelFor(view.y, view.y + view.height, SHADE_ROWS, [this, &view, &target, &shaded](int first, int last)
+        {
+            shaded += ShadeVisible(view, target, view.x, first, view.width, last - first);
+        });
+
+        Rasterizer::stats.pixels_shaded += shaded;
+    }
+
+    view.stats = Rasterizer::stats;
+    Rasterizer::stats = thread_stats;
+}
+
+
+
+/**
+* @brief CullOccluded:  marks the objects of a view that are hidden. The nearest objects that
+*                       cover a large part of the view are drawn to a low resolution depth
+*                       buffer, then the rectangle of every object is tested against it
+*
+* @param view:          view with the transformed vertices and bounds of every object
+* @param mesh_vertices: vertices of the mesh of every object
+*/
+void Airplane::CullOccluded(View& view, int mesh_vertices)
+{
+    PROFILE_SCOPE(occlusion);
+
+    const int objects = static_cast<int>(view.bounds.size());
+    Occlusion::Clear(view.occlusion, view.x, view.y, view.width, view.height);
+
+    //Only the large objects are worth drawing, the cube of every object is convex.
+    //The outline needs all the vertices, not only the ones of the clusters left
+    const float min_area = OCCLUDER_CELLS * view.occlusion.cell_width * view.occlusion.cell_height;
+    view.occluders.clear();
+    for (int obj = 0; obj < objects; obj++)
+    {
+        const Bounds& bounds = view.bounds[obj];
+        if (bounds.testable && bounds.whole && (bounds.right - bounds.left) * (bounds.bottom - bounds.top) >= min_area)
+            view.occluders.push_back(obj);
+    }
+
+    //The nearest ones hide the most
+    if (static_cast<int>(view.occluders.size()) > MAX_OCCLUDERS)
+    {
+        std::partial_sort(view.occluders.begin(), view.occluders.begin() + MAX_OCCLUDERS, view.occluders.end(),
+                          [&view](int a, int b)
+        {
+            return view.bounds[a].near_z < view.bounds[b].near_z || (view.bounds[a].near_z == view.bounds[b].near_z && a < b);
+        });
+        view.occluders.resize(MAX_OCCLUDERS);
+    }
+
+    for (int obj : view.occluders)
+        Occlusion::DrawOccluder(view.occlusion, &view.vertices[obj * mesh_vertices],
+                                static_cast<int>(lods.levels[view.levels[obj]].vertices.size()));
+
+    //A pixel more around every object, the lines round to the closest pixel
+    JobSystem::ParallelFor(0, objects, OBJECT_GRAIN, [this, &view](int first, int last)
+    {
+        for (int obj = first; obj < last; obj++)
+        {
+            Bounds& bounds = view.bounds[obj];
+            if (bounds.testable)
+                bounds.hidden = Occlusion::IsHidden(view.occlusion, bounds.left - 1.f, bounds.top - 1.f,
+                                                    bounds.right + 1.f, bounds.bottom + 1.f, bounds.near_z - OCCLUSION_BIAS);
+        }
+    });
+}
+
+
+
+/**
+* @brief UpdateBvh: makes the hierarchy fit the objects of a frame. It is built again when
+*                   the objects change, otherwise only the boxes of the objects whose transform
+*                   changed and the nodes above them are fit again
+*
+* @param m2w:       model to world of every object
+*/
+void Airplane::UpdateBvh(const std::vector<Matrix4>& m2w)
+{
+    PROFILE_SCOPE(frustum);
+
+    const int objects = static_cast<int>(m2w.size());
+    if (static_cast<int>(bvh_m2w.size()) != objects)
+    {
+        //Box of the mesh, the same for every object
+        mesh_box = Bvh::Box{ { 0.f, 0.f, 0.f }, { 0.f, 0.f, 0.f } };
+        for (size_t v = 0; v < parser->vertices.size(); v++)
+        {
+            const Point4& vertex = parser->vertices[v];
+            for (int axis = 0; axis < 3; axis++)
+            {
+                mesh_box.min[axis] = v == 0 ? vertex.v[axis] : std::fmin(mesh_box.min[axis], vertex.v[axis]);
+                mesh_box.max[axis] = v == 0 ? vertex.v[axis] : std::fmax(mesh_box.max[axis], vertex.v[axis]);
+            }
+        }
+
+        object_boxes.resize(objects);
+        for (int obj = 0; obj < objects; obj++)
+            object_boxes[obj] = Bvh::TransformBox(mesh_box, m2w[obj]);
+
+        Bvh::Build(bvh, object_boxes);
+        bvh_m2w = m2w;
+        return;
+    }
+
+    //Any change of the bits, the boxes have to contain the objects exactly. Only the
+    //dynamic objects can change
+    moved.clear();
+    for (int obj : dynamic_objects)
+    {
+        if (std::memcmp(m2w[obj].v, bvh_m2w[obj].v, sizeof(m2w[obj].v)) != 0)
+        {
+            bvh_m2w[obj] = m2w[obj];
+            object_boxes[obj] = Bvh::TransformBox(mesh_box, m2w[obj]);
+            moved.push_back(obj);
+        }
+    }
+
+    if (!moved.empty())
+        Bvh::Refit(bvh, moved, object_boxes);
+}
+
+
+
+/**
+* @brief DrawTiles: draws the triangles of a view one tile at a time. Every tile is
+*                   copied to a small buffer of its thread, which stays in the cache
+*                   while all of its triangles are drawn, and copied back once
+*
+* @param frame:     snapshot of the frame
+* @param view:      view with the transformed triangles
+*/
+void Airplane::DrawTiles(const Snapshot& frame, View& view)
+{
+    PROFILE_SCOPE(raster);
+
+    const int size = tile_size;
+
+    //Tiles of the rectangle of the view, the last ones can be smaller
+    view.tiles_x = (view.width + size - 1) / size;
+    view.tiles_y = (view.height + size - 1) / size;
+    const int tiles = view.tiles_x * view.tiles_y;
+
+    view.bins.resize(tiles);
+    view.tile_stats.resize(tiles);
+    for (std::vector<int>& bin : view.bins)
+        bin.clear();
+
+    //Add every triangle to the tiles its box touches, in drawing order
+    for (int slot : view.slots)
+    {
+        const PixelBox& box = view.boxes[slot];
+        if (box.left > box.right || box.top > box.bottom)
+            continue;
+
+        int first_x = (box.left - view.x) / size;
+        int last_x  = (box.right - view.x) / size;
+        int first_y = (box.top - view.y) / size;
+        int last_y  = (box.bottom - view.y) / size;
+
+        for (int tile_y = first_y; tile_y <= last_y; tile_y++)
+            for (int tile_x = first_x; tile_x <= last_x; tile_x++)
+                view.bins[tile_y * view.tiles_x + tile_x].push_back(slot);
+    }
+
+    //Every tile on any thread, each pixel gets the same writes in the same order as without tiles
+    FrameBuffer::Buffer& target = FrameBuffer::GetBound();
+    JobSystem::ParallelFor(0, tiles, 1, [this, &frame, &view, &target, size](int first, int last)
+    {
+        //The thread keeps its tile for the next frames
+        if (tile.size != size)
+        {
+            FrameBuffer::Release(tile.buffer);
+            FrameBuffer::Allocate(tile.buffer, size, size);
+            tile.size = size;
+        }
+
+        FrameBuffer::Buffer& previous = FrameBuffer::GetBound();
+        Rasterizer::Stats thread_stats = Rasterizer::stats;
+
+        for (int index = first; index < last; index++)
+        {
+            Rasterizer::ResetStats();
+
+            //A tile without triangles keeps the pixels of the framebuffer
+            const std::vector<int>& bin = view.bins[index];
+            if (!bin.empty())
+            {
+                int x = view.x + (index % view.tiles_x) * size;
+                int y = view.y + (index / view.tiles_x) * size;
+                int w = view.x + view.width - x < size ? view.x + view.width - x : size;
+                int h = view.y + view.height - y < size ? view.y + view.height - y : size;
+
+                FrameBuffer::ReadTile(target, tile.buffer, x, y, w, h);
+                FrameBuffer::Bind(tile.buffer);
+
+                if (shading_mode == depth_prepass && frame.draw_mode != wireframe)
                 {
-                    //Every line composing the triangle
-                    Rasterizer::DrawMidpointLine(vtx[0], vtx[1]);
-                    Rasterizer::DrawMidpointLine(vtx[1], vtx[2]);
-                    Rasterizer::DrawMidpointLine(vtx[2], vtx[0]);
+                    for (int slot : bin)
+                        DrawTriangle(frame.draw_mode, &view.triangles[3 * slot], slot + 1, true);
                 }
+
+                for (int slot : bin)
+                    DrawTriangle(frame.draw_mode, &view.triangles[3 * slot], slot + 1);
+
+                //The tile is colored while it is still in the cache
+                if (shading_mode == visibility && frame.draw_mode != wireframe)
+                    Rasterizer::stats.pixels_shaded += ShadeVisible(view, tile.buffer, x, y, w, h);
+
+                FrameBuffer::WriteTile(tile.buffer, target);
             }
+
+            view.tile_stats[index] = Rasterizer::stats;
         }
 
+        FrameBuffer::Bind(previous);
+        Rasterizer::stats = thread_stats;
+    });
+
+    //The pixels of every tile, but every triangle only once. The lines are stepped again in every tile they touch
+    for (const Rasterizer::Stats& stats : view.tile_stats)
+    {
+        Rasterizer::stats.pixels_tested += stats.pixels_tested;
+        Rasterizer::stats.pixels_passed += stats.pixels_passed;
+        Rasterizer::stats.lines_stepped += stats.lines_stepped;
+        Rasterizer::stats.pixels_shaded += stats.pixels_shaded;
+        Rasterizer::stats.prepass_tested += stats.prepass_tested;
     }
+    if (frame.draw_mode != wireframe)
+        Rasterizer::stats.triangles_rasterized += view.slots.size();
+}
+
+/**
+* @brief DrawTriangle:  draws a triangle with the drawing mode of the frame
+*
+* @param mode:          drawing mode of the frame
+* @param vtx:           the 3 vertices of the triangle
+* @param id:            slot of the triangle plus 1, kept in the visibility buffer
+* @param depth_only:    only the depth, for the prepass
+*/
+void Airplane::DrawTriangle(unsigned mode, const Rasterizer::Vertex* vtx, unsigned id, bool depth_only)
+{
+    if (depth_only)
+        Rasterizer::DrawTriangleDepth(vtx[0], vtx[1], vtx[2]);
+    else if (mode == wireframe)
+    {
+        //Every line composing the triangle
+        Rasterizer::DrawMidpointLine(vtx[0], vtx[1]);
+        Rasterizer::DrawMidpointLine(vtx[1], vtx[2]);
+        Rasterizer::DrawMidpointLine(vtx[2], vtx[0]);
+    }
+    else if (shading_mode == visibility)
+        Rasterizer::DrawTriangleVisibility(vtx[0], vtx[1], vtx[2], id);
+    else if (shading_mode == depth_prepass)
+        Rasterizer::DrawTriangleEqual(vtx[0], vtx[1], vtx[2]);
+    else
+        Rasterizer::DrawTriangleSolid(vtx[0], vtx[1], vtx[2]);
+}
+
+/**
+* @brief ShadeVisible:  colors the pixels of a rectangle that kept the id of a triangle
+*
+* @param view:          view with the transformed triangles
+* @param buffer:        buffer with the ids, the rectangle is clipped to it
+* @param x, y:          top left pixel of the rectangle, in screen pixels
+* @param w, h:          size of the rectangle
+* @return               pixels colored
+*/
+unsigned long long Airplane::ShadeVisible(const View& view, FrameBuffer::Buffer& buffer, int x, int y, int w, int h)
+{
+    return FrameBuffer::ResolveIds(buffer, x, y, w, h, [&view](int px, int py, unsigned id)
+    {
+        const Rasterizer::Vertex* vtx = &view.triangles[3 * (id - 1)];
+        return Rasterizer::InterpolateColor(vtx[0], vtx[1], vtx[2], static_cast<float>(px), static_cast<float>(py));
+    });
+}
+
+
+
+/**
+* @brief SetDrawMode:   select the drawing mode without user input
+*
+* @param mode:          depth_buffer, wireframe, solid or overdraw
+*/
+void Airplane::SetDrawMode(unsigned mode)
+{
+    draw_mode = mode;
+}
+
+/**
+* @brief SetCamera: select the camera without user input
+*
+* @param persp:     first, rooted, third or scripted
+*/
+void Airplane::SetCamera(int persp)
+{
+    camera_persp = persp;
+
+    //The rooted camera does not get updated every frame
+    if (camera_persp == rooted)
+        RootedCamera();
+    else if (camera_persp == scripted)
+        ScriptedCamera();
+}
+
+
+
+/**
+* @brief SetTileSize:   draw in tiles without user input
+*
+* @param size:          pixels of the side of a tile, 0 to draw to the framebuffer directly
+*/
+void Airplane::SetTileSize(int size)
+{
+    tile_size = size > 0 ? size : 0;
+}
+
+/**
+* @brief SetShading:    select how the pixels get their colors without user input
+*
+* @param mode:          forward, visibility or depth_prepass
+*/
+void Airplane::SetShading(int mode)
+{
+    shading_mode = mode;
+}
+
+/**
+* @brief SetDrawOrder:  select the order of the objects without user input
+*
+* @param order:         file_order or front_to_back
+*/
+void Airplane::SetDrawOrder(int order)
+{
+    draw_order = order;
+}
+
+/**
+* @brief SetOcclusionCulling:   skip the objects hidden behind the large ones without user input
+*
+* @param enabled:               true to test the objects against the occluders
+*/
+void Airplane::SetOcclusionCulling(bool enabled)
+{
+    occlusion_culling = enabled;
+}
+
+/**
+* @brief SetFrustumCulling: skip the objects outside of the views without user input
+*
+* @param enabled:           true to query the hierarchy of the objects for every view
+*/
+void Airplane::SetFrustumCulling(bool enabled)
+{
+    frustum_culling = enabled;
+}
+
+/**
+* @brief SetLevelOfDetail:  draw the objects far away with simpler meshes without user input
+*
+* @param enabled:           true to select a level of detail for every object and skip
+*                           the ones smaller than a pixel
+*/
+void Airplane::SetLevelOfDetail(bool enabled)
+{
+    level_of_detail = enabled;
+}
+
+/**
+* @brief SetMeshletCulling: skip the clusters of faces outside of the views or turned away
+*                           from the camera without user input
+*
+* @param enabled:           true to test the clusters of every object
+*/
+void Airplane::SetMeshletCulling(bool enabled)
+{
+    meshlet_culling = enabled;
+}
+
+/**
+* @brief SetStaticBatching: draw the objects that never move from their world vertices,
+*                           with only the camera of every view, without user input
+*
+* @param enabled:           true to transform the static objects to the world once
+*/
+void Airplane::SetStaticBatching(bool enabled)
+{
+    static_batching = enabled;
+}
+
+/**
+* @brief SetLayout: select the views without user input
+*
+* @param layout:    single, split or picture_in_picture
+*/
+void Airplane::SetLayout(int layout)
+{
+    view_layout = layout;
 }
 
 
@@ -149,35 +1201,92 @@ void Airplane::Airplane_Update()
 /**
 * @brief Viewport_Transformation: calculate the viewport transformation matrix
 *
-* @param (void)
+* @param view:                    rectangle of the screen to draw to
+* @return                         the viewport matrix of the view
 */
-void Airplane::Viewport_Transformation()
+Matrix4 Airplane::Viewport_Transformation(const View& view)
 {
     //Viewport transformation
+    Matrix4 viewport;
     viewport.Identity();
-    viewport.m[0][0] = static_cast<float>(WIDTH);
-    viewport.m[0][3] = WIDTH / 2.f;
-    viewport.m[1][1] = static_cast<float>(-HEIGHT);
-    viewport.m[1][3] = HEIGHT / 2.f;
+    viewport.m[0][0] = static_cast<float>(view.width);
+    viewport.m[0][3] = view.x + view.width / 2.f;
+    viewport.m[1][1] = static_cast<float>(-view.height);
+    viewport.m[1][3] = view.y + view.height / 2.f;
 
+    return viewport;
 }
 
 /**
 * @brief Perspective_Projection: calculate the perspective projection matrix
 *
-* @param (void)
+* @param view:                   rectangle of the screen to draw to
+* @return                        the perspective matrix with the aspect ratio of the view
 */
-void Airplane::Perspective_Transform()
+Matrix4 Airplane::Perspective_Transform(const View& view)
 {
-    float a = static_cast<float>(WIDTH) / HEIGHT;
+    float a = static_cast<float>(view.width) / view.height;
 
     //Perspective projection
+    Matrix4 persp_transf;
+    persp_transf.Zero();
     persp_transf.m[0][0] = parser->focal / view_width;
     persp_transf.m[1][1] = a * parser->focal / view_width;
     persp_transf.m[2][2] = (-parser->nearPlane - parser->farPlane) / (parser->farPlane - parser->nearPlane);
     persp_transf.m[2][3] = (-2 * parser->nearPlane * parser->farPlane) / (parser->farPlane - parser->nearPlane);
     persp_transf.m[3][2] = -1;
 
+    return persp_transf;
+}
+
+/**
+* @brief SetupViews:    place the views of a layout on the screen
+*                       and calculate their matrices
+*
+* @param layout:        single, split or picture_in_picture
+*/
+void Airplane::SetupViews(int layout)
+{
+    const int inset_width  = WIDTH / 4;
+    const int inset_height = HEIGHT / 4;
+    const int margin       = 8;
+
+    for (int i = 0; i < MAX_VIEWS; i++)
+    {
+        View& view = views[i];
+
+        //Main view on the whole screen
+        view.x      = 0;
+        view.y      = 0;
+        view.width  = WIDTH;
+        view.height = HEIGHT;
+
+        if (layout == split)
+        {
+            //Main view on the top half, the other two side by side below it
+            view.height = HEIGHT / 2;
+            if (i > 0)
+            {
+                view.x      = (i - 1) * (WIDTH / 2);
+                view.y      = HEIGHT / 2;
+                view.width  = i == 1 ? WIDTH / 2 : WIDTH - WIDTH / 2;
+                view.height = HEIGHT - HEIGHT / 2;
+            }
+        }
+        else if (layout == picture_in_picture && i > 0)
+        {
+            //Small views on the top corners
+            view.x      = i == 1 ? margin : WIDTH - margin - inset_width;
+            view.y      = margin;
+            view.width  = inset_width;
+            view.height = inset_height;
+        }
+
+        view.viewport   = Viewport_Transformation(view);
+        view.projection = Perspective_Transform(view);
+    }
+
+    views_layout = layout;
 }
 
 
@@ -190,7 +1299,7 @@ void Airplane::Perspective_Transform()
 */
 void Airplane::FirstPersonCamera()
 {
-    CS250Parser::Transform* body = FindObject("body");
+    CS250Parser::Transform* body = &parser->objects[body_index];
 
     //Set the camera information
     camera_position = body->m2w * Point4();    
@@ -228,7 +1337,7 @@ void Airplane::RootedCamera()
 void Airplane::ThirdPersonCamera()
 {
     //Calculate the m2w matrix of the body
-    CS250Parser::Transform* body = FindObject("body");
+    CS250Parser::Transform* body = &parser->objects[body_index];
 
     //Get the position of the plane
     Point4 airplane_pos = body->m2w * Point4();
@@ -242,6 +1351,96 @@ void Airplane::ThirdPersonCamera()
     w2c = WorldToCamera_Orth();
 }
 
+/**
+* @brief ScriptedCamera:    set the camera info from the scripted camera path
+*                           and calculate the corresponding w2c matrix
+*
+* @param (void)
+*/
+void Airplane::ScriptedCamera()
+{
+    //Keep the previous camera if there is no path
+    if (CameraPath::IsLoaded())
+        CameraPath::Sample(static_cast<float>(tick_count), camera_position, camera_view, camera_up);
+
+    //Set the new w2c matrix
+    w2c = WorldToCamera_Orth();
+}
+
+/**
+* @brief PoseMatrix:    calculate the w2c matrix of a camera pose given without user input,
+*                       the camera information is not changed
+*
+* @param position:      position of the camera
+* @param view:          direction the camera looks at
+* @param up:            up direction of the camera
+* @return               the w2c matrix of the pose
+*/
+Matrix4 Airplane::PoseMatrix(const Point4& position, const Vector4& view, const Vector4& up)
+{
+    Point4  previous_position = camera_position;
+    Vector4 previous_view     = camera_view;
+    Vector4 previous_up       = camera_up;
+
+    camera_position = position;
+    camera_view     = view;
+    camera_up       = up;
+    Matrix4 pose    = WorldToCamera_Orth();
+
+    camera_position = previous_position;
+    camera_view     = previous_view;
+    camera_up       = previous_up;
+
+    return pose;
+}
+
+/**
+* @brief CameraMatrix:  calculate the w2c matrix of any camera,
+*                       the camera information is left as the one of the given camera
+*
+* @param persp:         first, rooted, third or scripted
+* @return               the w2c matrix of the camera
+*/
+Matrix4 Airplane::CameraMatrix(int persp)
+{
+    if (persp == first)
+        FirstPersonCamera();
+    else if (persp == rooted)
+        RootedCamera();
+    else if (persp == third)
+        ThirdPersonCamera();
+    else if (persp == scripted)
+        ScriptedCamera();
+
+    return w2c;
+}
+
+/**
+* @brief ViewCamera:    camera drawn by a view of the current layout
+*
+* @param index:         view, the first one is the main view
+* @return               first, rooted, third or scripted
+*/
+int Airplane::ViewCamera(int index)
+{
+    static const int cameras[] = {first, rooted, third};
+
+    if (view_layout == split)
+        return cameras[index];
+
+    if (index == 0)
+        return camera_persp;
+
+    //The small views show the cameras that are not the main one
+    for (int camera : cameras)
+    {
+        if (camera != camera_persp && --index == 0)
+            return camera;
+    }
+
+    return camera_persp;
+}
+
 /**
 * @brief WorldToCamera_Orth:    calculate the world to camera matrix
 *
@@ -358,14 +1557,17 @@ CS250Parser::Transform* Airplane::FindObject(std::string obj)
 }
 
 /**
-* @brief ModelToWorld:  calculate the model to world matrix of the object
+* @brief LocalTransform:    calculate the transform of the object without its parents,
+*                           it only changes the object so every object can be done at once
 *
-* @param obj:           object to calculate the matrix for
-* @param scale:         whether to calculate the scale
-* @return               model to world matrix
+* @param index:             index of the object to calculate the matrix for
+* @param scale:             whether to calculate the scale
+* @return                   model to parent matrix
 */
-Matrix4 Airplane::ModelToWorld(CS250Parser::Transform& obj, bool scale)
+Matrix4 Airplane::LocalTransform(int index, bool scale)
 {
+    CS250Parser::Transform& obj = parser->objects[index];
+
     //Translation
     Matrix4 Transl;
     {
@@ -410,14 +1612,24 @@ Matrix4 Airplane::ModelToWorld(CS250Parser::Transform& obj, bool scale)
     obj.m2w = Transl * Rot;
 
 
-    //If there is a parent, multiply its M2W matrix
-    CS250Parser::Transform* parent = FindObject(obj.parent);
-    while (parent)
-    {
-        m2w = parent->m2w * m2w;
-        parent = FindObject(parent->parent);
-    }
+    return m2w;
+}
+
+/**
+* @brief ModelToWorld:  calculate the model to world matrix of the object, the
+*                       transforms of its parents have to be updated already
+*
+* @param index:         index of the object to calculate the matrix for
+* @param local:         transform of the object without its parents
+* @return               model to world matrix
+*/
+Matrix4 Airplane::ModelToWorld(int index, const Matrix4& local)
+{
+    Matrix4 m2w = local;
 
+    //If there is a parent, multiply its M2W matrix
+    for (int parent = parents[index]; parent >= 0; parent = parents[parent])
+        m2w = parser->objects[parent].m2w * m2w;
 
     return m2w;
 }
@@ -453,14 +1665,17 @@ Matrix4 Airplane::OrthogonalMethod(CS250Parser::Transform& obj)
 */
 unsigned Airplane::GetInput()
 {
-    CS250Parser::Transform* body = FindObject("body");
+    CS250Parser::Transform* body = &parser->objects[body_index];
+
+    //Key state of this frame (keyboard or replay)
+    Input::NextFrame();
 
     //Roll airplane body
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::A))
+    if (Input::IsKeyPressed(Input::A))
     {
         body->rot.z = ROT_ANGLE;
     }
-    else if (sf::Keyboard::isKeyPressed(sf::Keyboard::D))
+    else if (Input::IsKeyPressed(Input::D))
     {
         body->rot.z = -ROT_ANGLE;
     }
@@ -471,11 +1686,11 @@ unsigned Airplane::GetInput()
 
 
     //Yaw airplane body 
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Q))
+    if (Input::IsKeyPressed(Input::Q))
     {
         body->rot.y = ROT_ANGLE;
     }   
-    else if (sf::Keyboard::isKeyPressed(sf::Keyboard::E))
+    else if (Input::IsKeyPressed(Input::E))
     {
         body->rot.y = -ROT_ANGLE;
     }
@@ -486,11 +1701,11 @@ unsigned Airplane::GetInput()
 
 
     //Pitch airplane body 
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::W))
+    if (Input::IsKeyPressed(Input::W))
     {
         body->rot.x = ROT_ANGLE;
     }
-    else if (sf::Keyboard::isKeyPressed(sf::Keyboard::S))
+    else if (Input::IsKeyPressed(Input::S))
     {
         body->rot.x = -ROT_ANGLE;
     }
@@ -500,28 +1715,39 @@ unsigned Airplane::GetInput()
     }
 
     //Move airplane forward
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Space))
+    if (Input::IsKeyPressed(Input::Space))
     {
         //Move body
         body->pos += body->fwd * 2.f;
     }
 
 
+    //Switch the views
+    if (Input::IsKeyPressed(Input::Num7))
+        view_layout = split;
+    if (Input::IsKeyPressed(Input::Num8))
+        view_layout = picture_in_picture;
+    if (Input::IsKeyPressed(Input::Num9))
+        view_layout = single;
+
+
     //Check solid/wireframe mode
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Num0))
+    if (Input::IsKeyPressed(Input::Num0))
         return depth_buffer;
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Num1))
+    if (Input::IsKeyPressed(Input::Num1))
         return wireframe;
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Num2))
+    if (Input::IsKeyPressed(Input::Num2))
         return solid;
+    if (Input::IsKeyPressed(Input::Num6))
+        return overdraw;
 
 
     //Switch camera mode
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Num3))
+    if (Input::IsKeyPressed(Input::Num3))
         camera_persp = first;
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Num4))
+    if (Input::IsKeyPressed(Input::Num4))
         camera_persp = third;
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Num5))
+    if (Input::IsKeyPressed(Input::Num5))
     {
         camera_persp = rooted;
         RootedCamera();         //Don't need to call it every time
@@ -529,22 +1755,22 @@ unsigned Airplane::GetInput()
 
 
     //Camera distance
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Z))
+    if (Input::IsKeyPressed(Input::Z))
     {
         if (parser->distance - MOVE_DIST > 0.f)
             parser->distance -= MOVE_DIST;
     }
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::X))
+    if (Input::IsKeyPressed(Input::X))
         parser->distance += MOVE_DIST;
 
 
     //Camera height
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::H))
+    if (Input::IsKeyPressed(Input::H))
     {
         if(parser->height - MOVE_DIST > 0.f)
             parser->height -= MOVE_DIST;
     }
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Y))
+    if (Input::IsKeyPressed(Input::Y))
         parser->height += MOVE_DIST;
 
 
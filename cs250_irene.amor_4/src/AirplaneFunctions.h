@@ -12,20 +12,36 @@
 This file contains the implementation of the following class functions for the
 second Airplane assignment.
 Functions include:	Airplane_Initialize, Viewport_Transformation, Perspective_Transform,
-					ModelToWorld, OrthogonalMethod, WorldToCamera_Orth, AxisAngleMethod,
+					LocalTransform, ModelToWorld, OrthogonalMethod, WorldToCamera_Orth, AxisAngleMethod,
 					FindObject, FirstPersonCamera, RootedCamera, ThirdPersonCamera,
-					Airplane_Update, GetInput, tensor_product, get_matrix
+					ScriptedCamera, CameraMatrix, ViewCamera,
+					Airplane_Update, Simulate, Tick, Render, DrawView, SetupViews, GetInput,
+					tensor_product, get_matrix, SetDrawMode, SetCamera, SetLayout, PoseMatrix,
+					SetTileSize, DrawTiles, DrawTriangle, UpdateSceneInfo,
+					SetShading, ShadeVisible, SetDrawOrder,
+					SetOcclusionCulling, CullOccluded, SetFrustumCulling, UpdateBvh,
+					SetLevelOfDetail, SetMeshletCulling, SetStaticBatching
 
 Hours spent on this assignment: ~12
 
 */
 /****************************************************************************************/
 
-#include <SFML/Graphics.hpp>
+#pragma once
 
 #include "FrameBuffer.h"		//Frame buffer class
 #include "Rasterizer.h"			//Rasterizer class
 #include "CS250Parser.h"		//Parser class
+#include "Input.h"				//Recorded or live key states
+#include "CameraPath.h"			//Scripted camera path
+#include "Profiler.h"			//Per-stage timers
+#include "JobSystem.h"			//Worker threads
+#include "DrawList.h"			//Objects sorted by distance
+#include "Occlusion.h"			//Low resolution depth of the occluders
+#include "Bvh.h"				//Hierarchy of the world boxes of the objects
+#include "Lod.h"				//Simpler meshes for the objects far away
+#include "StaticBatch.h"		//World vertices of the objects that never move
+#include <vector>
 #include "Math/Matrix4.h"		//Matrix 4*4 class
 #include "Math/Point4.h"		//Point of size 4 class
 
@@ -34,12 +50,46 @@ class Airplane
 {
 public:
 
+	static const int MAX_VIEWS = 3;	//Cameras drawn at once
+
+	//What the renderer needs from the simulation of a frame
+	struct Snapshot
+	{
+		std::vector<Matrix4> m2w;		//Model to world with scale of every object
+		unsigned scene = 0;				//Scene the transforms of the static objects are from
+		Matrix4 w2c[MAX_VIEWS];			//Camera of every view, the first one is the main view
+		int views = 1;
+		int view_layout = single;
+		unsigned draw_mode = solid;
+	};
+
 	//------------
 	//Functions
 	//------------
 
+	Airplane(int width = 1280, int height = 960) : WIDTH(width), HEIGHT(height) {}
+
+	static constexpr double TICK = 1.0 / 60.0;			//Seconds simulated by each step, whatever the frame rate
+
 	void Airplane_Initialize();							//Initialize airplane object
-	void Airplane_Update();								//Renders the current state of the airplane
+	void UpdateSceneInfo();								//Object count, hierarchy and mesh after the scene changes
+	void Airplane_Update();								//Simulates and renders the next frame
+
+	void Simulate(Snapshot& out, double elapsed = TICK);	//Steps up to the time of the next frame and interpolates it
+	void Render(const Snapshot& frame);					//Draws a simulated frame, can run along Simulate
+
+	void SetDrawMode(unsigned mode);					//Select the drawing mode without user input
+	void SetCamera(int persp);							//Select the camera without user input
+	void SetLayout(int layout);							//Select the views without user input
+	Matrix4 PoseMatrix(const Point4& position, const Vector4& view, const Vector4& up);	//w2c matrix of a camera pose
+	void SetTileSize(int size);							//Draw in tiles of size*size pixels, 0 to draw to the framebuffer directly
+	void SetShading(int mode);							//Select how the pixels get their colors without user input
+	void SetDrawOrder(int order);						//Select the order of the objects without user input
+	void SetOcclusionCulling(bool enabled);				//Skip the objects hidden behind the large ones
+	void SetFrustumCulling(bool enabled);				//Skip the objects outside of the views with the hierarchy
+	void SetLevelOfDetail(bool enabled);				//Simpler meshes far away, skip the objects smaller than a pixel
+	void SetMeshletCulling(bool enabled);				//Skip the clusters of faces outside of the views or turned away
+	void SetStaticBatching(bool enabled);				//Only the camera for the objects that never move
 
 	//------------
 	//Variables
@@ -48,19 +98,77 @@ public:
 	const int WIDTH = 1280;							//Window size
 	const int HEIGHT = 960;
 
+	enum camera{first, rooted, third, scripted};
+	enum draw_mode {depth_buffer, wireframe, solid, overdraw};
+	enum layout {single, split, picture_in_picture};	//Main camera only, the three cameras side by side, or over the main one
+	enum shading {forward, visibility, depth_prepass};	//Color while drawing, from the ids of the visible triangles, or after the final depth
+	enum order {file_order, front_to_back};				//Objects in the order of the input file, or the nearest ones first
+
 private:
 
 	//------------
 	//Functions
 	//------------
-	void Viewport_Transformation();					//Calculate the viewport transformation matrix
-	void Perspective_Transform();					//Calculate the perspective projection matrix
+	//Screen rectangle and depth range of an object in a view
+	struct Bounds
+	{
+		float left, top, right, bottom;
+		float near_z, far_z;
+		bool testable;		//All of it is in front of the camera
+		bool hidden;		//Behind the occluders
+		bool whole;			//Every vertex was transformed, no cluster was skipped
+	};
+
+	//Pixels of a view a triangle can touch, empty if it draws none
+	struct PixelBox
+	{
+		short left, top, right, bottom;
+	};
+
+	//Part of the framebuffer a camera is drawn to
+	struct View
+	{
+		int x = 0, y = 0, width = 0, height = 0;	//Rectangle of the framebuffer
+		Matrix4 viewport;							//From the projection to the rectangle
+		Matrix4 projection;							//Perspective with the aspect of the rectangle
+		std::vector<int> objects;					//Objects that can be in the view, in the order of the scene
+		std::vector<Rasterizer::Vertex> triangles;	//Transformed vertices of every triangle, 3 per triangle
+		std::vector<Point4> vertices;				//Transformed vertices of the mesh of each of them
+		std::vector<unsigned char> behind;			//Whether each vertex is behind the camera
+		std::vector<Bounds> bounds;					//Screen rectangle of each of the objects
+		std::vector<int> levels;					//Level of detail of each of them, -1 if too small to be seen
+		std::vector<unsigned char> clusters;		//Whether each cluster of each of them is drawn, as a triangle state
+		Occlusion::Buffer occlusion;				//Depth of the occluders
+		std::vector<int> occluders;					//Objects drawn to it
+		std::vector<unsigned char> triangle_states;	//Whether each triangle is drawn
+		std::vector<DrawList::Draw> draws;			//Objects in drawing order
+		std::vector<DrawList::Draw> draws_scratch;	//Memory of the sort
+		std::vector<int> slots;						//Triangles that are not culled, in drawing order
+		Rasterizer::Stats stats;					//Counters of the last frame of the view
 
-	Matrix4 ModelToWorld(CS250Parser::Transform &obj, bool scale = true);	//Calculate the m2w matrix of each object
+		int tiles_x = 0, tiles_y = 0;				//Tiles of the rectangle, when drawing in tiles
+		std::vector<PixelBox> boxes;				//Pixels each triangle can touch, when drawing in tiles
+		std::vector<std::vector<int>> bins;			//Triangles that touch every tile, in drawing order
+		std::vector<Rasterizer::Stats> tile_stats;	//Counters of every tile
+	};
+
+	Matrix4 Viewport_Transformation(const View& view);	//Calculate the viewport transformation matrix
+	Matrix4 Perspective_Transform(const View& view);	//Calculate the perspective projection matrix
+	void SetupViews(int layout);						//Rectangles and matrices of the views of a layout
+	void DrawView(const Snapshot& frame, int index);	//Draws the objects from the camera of a view
+	void DrawTiles(const Snapshot& frame, View& view);	//Draws the triangles of a view one tile at a time
+	void CullOccluded(View& view, int mesh_vertices);	//Marks the objects hidden behind the large ones
+	void UpdateBvh(const std::vector<Matrix4>& m2w);	//Builds the hierarchy or refits it to the objects that moved
+	void DrawTriangle(unsigned mode, const Rasterizer::Vertex* vtx, unsigned id, bool depth_only = false);	//Draws the triangle or its lines
+	unsigned long long ShadeVisible(const View& view, FrameBuffer::Buffer& buffer, int x, int y, int w, int h);	//Colors the pixels with an id
+
+	Matrix4 LocalTransform(int index, bool scale = true);					//Calculate the transform of each object without its parents
+	Matrix4 ModelToWorld(int index, const Matrix4& local);					//Calculate the m2w matrix of each object
 	Matrix4 OrthogonalMethod(CS250Parser::Transform& obj);					//Calculate the orthogonal rotation matrix of an object
 	Matrix4 WorldToCamera_Orth();											//Calculate the w2c for the corresponding camera
 	Matrix4 AxisAngleMethod(float angle, Vector4 vec);						//Calculate the axis angle method rotation matrix
 
+	void Tick();											//Input, transforms and camera of one fixed step
 	unsigned GetInput();									//Get user input
 
 	CS250Parser::Transform* FindObject(std::string obj);	//Find the object's transform from its name
@@ -68,6 +176,9 @@ private:
 	void FirstPersonCamera();						//Functions to get the information of the corresponding camera
 	void RootedCamera();
 	void ThirdPersonCamera();
+	void ScriptedCamera();
+	Matrix4 CameraMatrix(int persp);				//w2c matrix of any camera
+	int ViewCamera(int index);						//Camera of each view of the layout
 
 	Matrix4 tensor_product(Vector4 u, Vector4 v);	//Calculate the tensor product of two vectors
 	Matrix4 get_matrix(Vector4 u);					//Get the matrix of the vector
@@ -82,13 +193,33 @@ private:
 	size_t max_faces = 0;			//Number of faces per shape
 	size_t TOTAL_obj = 0;			//Objects on the scene
 
+	std::vector<int> parents;		//Index of the parent of each object, -1 for none
+	int body_index = -1;			//Index of the airplane body
+
 	CS250Parser* parser;			//Parser with input data
 
-	Matrix4 viewport;				//Matrices that only need to be computed once
-	Matrix4 persp_transf;
-	Matrix4 w2c;
+	Matrix4 w2c;					//Camera of the last camera function
+
+	std::vector<Point4> color;		//Color of each triangle
+
+	enum triangle_state {culled_triangle, drawn_triangle, clipped_triangle, occluded_triangle, simplified_triangle};
 
-	Point4 color[12];				//Color of each triangle
+	View views[MAX_VIEWS];						//Views of the layout, set up when the layout changes
+	int views_layout = -1;
+	Snapshot snapshot;							//Frame of Airplane_Update
+
+	std::vector<Matrix4> previous_m2w;			//Transforms of the last two steps, the frames are in between
+	std::vector<Matrix4> current_m2w;
+	unsigned previous_scene = 0;				//Scene of the static objects of each of them
+	unsigned current_scene = 0;
+	Matrix4 previous_w2c[MAX_VIEWS];
+	Matrix4 current_w2c[MAX_VIEWS];
+	bool cut = true;							//The last step can't be interpolated from the one before
+	int tick_camera = -1;						//Camera and layout of the last step
+	int tick_layout = -1;
+
+	double simulated_time = 0.0;				//Seconds simulated so far, ahead of the frames by less than a step
+	double frame_time = 0.0;					//Seconds of the frames rendered so far
 
 	unsigned draw_mode = solid;		//Drawing mode
 
@@ -96,10 +227,40 @@ private:
 	Vector4 camera_view;
 	Vector4 camera_up;
 
-	const float ROT_ANGLE = 0.05f;	//Angle to rotate by after the input
+	const float ROT_ANGLE = 0.05f;	//Angle to rotate by after the input, per step
 	const float MOVE_DIST = 7.5f;	//Distance to change the camera distance or height by
+	const int MAX_TICKS = 8;		//Steps per frame before the simulation falls behind instead
+	const int OBJECT_GRAIN = 64;	//Objects transformed by each job at least
+	const int SHADE_ROWS = 16;		//Rows colored by each job at least
+	const int MAX_OCCLUDERS = 64;	//Objects drawn to the occlusion buffer at most
+	const float OCCLUDER_CELLS = 64.f;		//Cells of the occlusion buffer an occluder covers at least
+	const float OCCLUSION_BIAS = 1e-5f;		//Depth an object has to be behind the occluders by
+	const float LOD_ERROR = 1.f;			//Pixels the vertices of a simpler level can move at most
+	const float MIN_OBJECT_PIXELS = 1.f;	//Objects smaller than this across the screen are not drawn
+	int tile_size = 0;				//Pixels of the side of a tile, 0 to draw without tiles
+	int shading_mode = forward;		//When the pixels get their colors
+	int draw_order = file_order;	//Order of the objects of every view
+	bool occlusion_culling = false;	//Test the objects against the occluders
+	bool frustum_culling = false;	//Query the hierarchy for the objects of every view
+	bool level_of_detail = false;	//Select a level of detail for every object
+	Lod::Chain lods;				//Levels of detail of the mesh
+	int max_clusters = 0;			//Clusters of the level with the most of them
+	bool meshlet_culling = false;	//Test the clusters of every object
+	bool static_batching = false;	//Draw the static objects from their world vertices
+
+	unsigned scene_version = 0;					//Changes with every call to UpdateSceneInfo
+	std::vector<int> static_objects;			//Objects that never move
+	std::vector<int> dynamic_objects;			//Objects moved by the input or rotating, and their children
+	std::vector<Matrix4> static_m2w;			//Model to world of the static objects, made once per scene
+	StaticBatch::Batch static_batch;			//World vertices of the static objects
+
+	Bvh::Tree bvh;								//Hierarchy of the world boxes of the objects
+	Bvh::Box mesh_box;							//Box of the mesh of every object
+	std::vector<Bvh::Box> object_boxes;			//World box of every object
+	std::vector<Matrix4> bvh_m2w;				//Transforms the boxes were made from
+	std::vector<int> moved;						//Objects whose transform changed since the last frame
 
 	int camera_persp = 0;			//Camera type
-	enum camera{first, rooted, third};
-	enum draw_mode {depth_buffer, wireframe, solid};
+	int view_layout = single;		//Views drawn every frame
+	unsigned tick_count = 0;		//Steps simulated, to follow the camera path
 };
\ No newline at end of file
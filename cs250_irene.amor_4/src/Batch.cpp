@@ -0,0 +1,257 @@
+/****************************************************************************************/
+/*!
+\file   Batch.cpp
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+This file contains the implementation of the batch renderer.
+Functions include:	Run, LoadPoses, Acquire, Release, RenderPose
+
+*/
+/****************************************************************************************/
+
+#include "Batch.h"      //Header file
+#include "Platform.h"   //fopen_s outside of MSVC
+#include <atomic>       //Failed writes
+#include <chrono>       //Timing
+#include <cstring>      //strcmp
+#include <memory>       //unique_ptr
+#include <mutex>        //Idle workers and stdout
+
+#ifdef _WIN32
+#include <io.h>         //_setmode
+#include <fcntl.h>      //_O_BINARY
+#endif
+
+namespace Batch
+{
+
+namespace
+{
+    //Everything a thread needs to render a pose. The scene is read only,
+    //so every worker has its own copy of the airplane state that Render changes
+    struct Worker
+    {
+        Worker(const Airplane & source, const Airplane::Snapshot & snapshot)
+            : airplane(source), frame(snapshot) {}
+
+        Airplane            airplane;
+        Airplane::Snapshot  frame;
+        FrameBuffer::Buffer target;
+    };
+
+    //State shared by the jobs of a run
+    struct Context
+    {
+        const Airplane *               airplane;
+        const Airplane::Snapshot *     frame;
+        const std::vector<Matrix4> *   poses;
+        const char *                   output;
+        bool                           to_stdout;
+
+        std::mutex                           lock;          //Workers and stdout
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::vector<Worker *>                idle;
+        std::atomic<bool>                    failed;
+    };
+
+
+    /**
+    * @brief LoadPoses: read the camera poses of a file
+    *
+    * @param airplane:  scene the w2c matrices are calculated for
+    * @param filename:  file with one pose per line
+    * @param poses:     w2c matrix of every pose read
+    * @return           whether the file could be read
+    */
+    bool LoadPoses(Airplane & airplane, const char * filename, std::vector<Matrix4> & poses)
+    {
+        FILE * in = nullptr;
+        fopen_s(&in, filename, "r");
+        if (!in)
+        {
+            std::fprintf(stderr, "Could not open poses %s\n", filename);
+            return false;
+        }
+
+        char line[512];
+        while (fgets(line, sizeof(line), in))
+        {
+            if (line[0] == '#')
+                continue;
+
+            Point4  position;
+            Vector4 view, up;
+            int read = sscanf_s(line, "%f,%f,%f %f,%f,%f %f,%f,%f",
+                                &position.x, &position.y, &position.z,
+                                &view.x, &view.y, &view.z,
+                                &up.x, &up.y, &up.z);
+            if (read == 9)
+                poses.push_back(airplane.PoseMatrix(position, view, up));
+        }
+        fclose(in);
+
+        return true;
+    }
+
+    /**
+    * @brief Acquire:   take a worker that is not rendering, or make a new one
+    *
+    * @param context:   run the worker is for
+    * @return           worker only used by the calling job until it is released
+    */
+    Worker * Acquire(Context & context)
+    {
+        std::lock_guard<std::mutex> guard(context.lock);
+
+        if (!context.idle.empty())
+        {
+            Worker * worker = context.idle.back();
+            context.idle.pop_back();
+            return worker;
+        }
+
+        context.workers.emplace_back(new Worker(*context.airplane, *context.frame));
+        Worker * worker = context.workers.back().get();
+        FrameBuffer::Allocate(worker->target, context.airplane->WIDTH, context.airplane->HEIGHT);
+        return worker;
+    }
+
+    /**
+    * @brief Release:   let other jobs use a worker
+    *
+    * @param context:   run the worker is for
+    * @param worker:    worker taken with Acquire
+    */
+    void Release(Context & context, Worker * worker)
+    {
+        std::lock_guard<std::mutex> guard(context.lock);
+        context.idle.push_back(worker);
+    }
+
+    /**
+    * @brief RenderPose:    render one pose with a worker and write the image
+    *
+    * @param context:       run the pose is from
+    * @param worker:        worker of the calling job
+    * @param index:         pose to render
+    */
+    void RenderPose(Context & context, Worker & worker, int index)
+    {
+        //While this job waits for its pieces the thread can run another pose,
+        //so the state of the thread is left as it was
+        FrameBuffer::Buffer & previous = FrameBuffer::GetBound();
+        Rasterizer::Stats     stats    = Rasterizer::stats;
+
+        FrameBuffer::Bind(worker.target);
+        FrameBuffer::Clear(255, 255, 255);
+
+        worker.frame.w2c[0] = (*context.poses)[index];
+        worker.airplane.Render(worker.frame);
+
+        FrameBuffer::Bind(previous);
+        Rasterizer::stats = stats;
+
+        //Write the image as soon as it is done
+        if (context.to_stdout)
+        {
+            char comment[32];
+            std::snprintf(comment, sizeof(comment), "pose %d", index);
+
+            std::lock_guard<std::mutex> guard(context.lock);
+            FrameBuffer::WritePPM(worker.target, stdout, comment);
+        }
+        else if (context.output)
+        {
+            char path[1024];
+            std::snprintf(path, sizeof(path), "%s/pose_%05d.ppm", context.output, index);
+
+            FILE * file = nullptr;
+            fopen_s(&file, path, "wb");
+            if (!file || !FrameBuffer::WritePPM(worker.target, file))
+            {
+                std::fprintf(stderr, "Could not write %s\n", path);
+                context.failed.store(true);
+            }
+            if (file)
+                std::fclose(file);
+        }
+    }
+}
+
+
+/**
+* @brief Run:       render the airplane scene from every pose of a file
+*
+* @param airplane:  initialized airplane scene
+* @param poses:     file with the camera poses
+* @param output:    nullptr, "-" for stdout or the directory to write the images to
+* @return           exit code of the program
+*/
+int Run(Airplane & airplane, const char * poses, const char * output)
+{
+    using clock = std::chrono::high_resolution_clock;
+
+    std::vector<Matrix4> cameras;
+    if (!LoadPoses(airplane, poses, cameras))
+        return 1;
+
+    bool to_stdout = output && !strcmp(output, "-");
+
+#ifdef _WIN32
+    //The images are binary data
+    if (to_stdout)
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+    clock::time_point start = clock::now();
+
+    //The scene is simulated once, then only the camera changes
+    Airplane::Snapshot frame;
+    airplane.Simulate(frame);
+    frame.views       = 1;
+    frame.view_layout = Airplane::single;
+
+    Context context;
+    context.airplane  = &airplane;
+    context.frame     = &frame;
+    context.poses     = &cameras;
+    context.output    = output;
+    context.to_stdout = to_stdout;
+    context.failed.store(false);
+
+    //Every job renders its poses one after the other with the same worker
+    int count = static_cast<int>(cameras.size());
+    JobSystem::ParallelFor(0, count, 1, [&context](int first, int last)
+    {
+        Worker * worker = Acquire(context);
+
+        for (int pose = first; pose < last && !context.failed.load(); pose++)
+            RenderPose(context, *worker, pose);
+
+        Release(context, worker);
+    });
+
+    if (to_stdout)
+        std::fflush(stdout);
+
+    for (std::unique_ptr<Worker> & worker : context.workers)
+        FrameBuffer::Release(worker->target);
+
+    double total_time = std::chrono::duration<double>(clock::now() - start).count();
+
+    //Report on stderr so it does not get mixed with the images on stdout
+    std::fprintf(stderr, "%d poses at %dx%d, %d threads, %zu framebuffers\n", count,
+                 airplane.WIDTH, airplane.HEIGHT, JobSystem::GetThreadCount(), context.workers.size());
+    if (count > 0)
+        std::fprintf(stderr, "total: %.3f s, %.2f poses/s, %.3f ms/pose\n",
+                     total_time, count / total_time, 1000.0 * total_time / count);
+
+    return context.failed.load() ? 1 : 0;
+}
+
+} // namespace Batch
@@ -0,0 +1,36 @@
+/****************************************************************************************/
+/*!
+\file   Batch.h
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+Offline rendering of the airplane scene from a list of camera poses, for
+generating datasets. The scene is simulated once and shared by every thread,
+each thread renders whole poses to its own framebuffer and the images are
+written as soon as they are done.
+Each line of the pose file is "px,py,pz vx,vy,vz ux,uy,uz" (position, view
+and up vectors of the camera), lines starting with # are ignored.
+Functions include:	Run
+
+*/
+/****************************************************************************************/
+
+#pragma once
+
+#include "AirplaneFunctions.h"
+
+namespace Batch
+{
+
+// Renders the scene from every pose of the file on all the threads of the job system.
+// output: nullptr to only render, "-" to stream PPM images to stdout in the order
+// they finish (the header comment of each image is "pose <index>"),
+// or a directory where pose_00000.ppm, pose_00001.ppm... are written.
+// Returns the exit code of the program.
+int Run(Airplane & airplane, const char * poses, const char * output);
+
+} // namespace Batch
@@ -0,0 +1,391 @@
+/****************************************************************************************/
+/*!
+\file   Benchmark.cpp
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+This file contains the implementation of the rasterizer benchmark.
+Functions include:	Run, BuildScene, AddGrid, SetSphereMesh, RunScene
+
+*/
+/****************************************************************************************/
+
+#include "Benchmark.h"          //Header file
+#include "AirplaneFunctions.h"  //Scene and renderer
+#include "JobSystem.h"          //Threads of every run
+#include <thread>               //hardware_concurrency
+#include <chrono>               //Frame timing
+#include <cstdio>
+#include <cmath>                //sinf, cosf
+#include <vector>               //Converted pixels
+
+namespace Benchmark
+{
+
+namespace
+{
+    typedef std::chrono::high_resolution_clock clock;
+
+    //Synthetic workloads
+    enum SceneType { input_scene, grid, large_triangles, tiny_triangles, wide_grid, sphere_grid };
+
+    struct Scene
+    {
+        const char * name;
+        SceneType    type;
+        int          nx, ny, nz;    //Cubes of the grids
+        unsigned     mode;          //Drawing mode
+        int          tiles;         //Side of the tiles, 0 without tiles
+        int          shading;       //When the pixels get their colors
+        int          order;         //Order of the objects
+        bool         occlusion;     //Skip the objects hidden behind the large ones
+        bool         bvh;           //Skip the objects outside of the view with the hierarchy
+        bool         lod;           //Simpler meshes far away, skip the objects smaller than a pixel
+        bool         meshlets;      //Skip the clusters of faces outside of the view or turned away
+        bool         static_batch;  //Only the camera for the objects that never move
+    };
+
+    const Scene SCENES[] =
+    {
+        {"input",           input_scene,     0,  0,  0,  Airplane::solid,     0,  Airplane::forward,       Airplane::file_order,    false, false, false, false, false},
+        {"grid_1k",         grid,            10, 10, 10, Airplane::solid,     0,  Airplane::forward,       Airplane::file_order,    false, false, false, false, false},
+        {"grid_10k",        grid,            25, 20, 20, Airplane::solid,     0,  Airplane::forward,       Airplane::file_order,    false, false, false, false, false},
+        {"grid_100k",       grid,            50, 40, 50, Airplane::solid,     0,  Airplane::forward,       Airplane::file_order,    false, false, false, false, false},
+        {"large_triangles", large_triangles, 0,  0,  0,  Airplane::solid,     0,  Airplane::forward,       Airplane::file_order,    false, false, false, false, false},
+        {"tiny_triangles",  tiny_triangles,  50, 40, 50, Airplane::solid,     0,  Airplane::forward,       Airplane::file_order,    false, false, false, false, false},
+        {"wireframe_10k",   grid,            25, 20, 20, Airplane::wireframe, 0,  Airplane::forward,       Airplane::file_order,    false, false, false, false, false},
+        {"grid_10k",        grid,            25, 20, 20, Airplane::solid,     64, Airplane::forward,       Airplane::file_order,    false, false, false, false, false},
+        {"large_triangles", large_triangles, 0,  0,  0,  Airplane::solid,     64, Airplane::forward,       Airplane::file_order,    false, false, false, false, false},
+        {"tiny_triangles",  tiny_triangles,  50, 40, 50, Airplane::solid,     64, Airplane::forward,       Airplane::file_order,    false, false, false, false, false},
+
+        //The same overdraw colored once: pixels_shaded against the prepass_tested and time it costs
+        {"grid_10k",        grid,            25, 20, 20, Airplane::solid,     0,  Airplane::depth_prepass, Airplane::file_order,    false, false, false, false, false},
+        {"large_triangles", large_triangles, 0,  0,  0,  Airplane::solid,     0,  Airplane::depth_prepass, Airplane::file_order,    false, false, false, false, false},
+        {"large_triangles", large_triangles, 0,  0,  0,  Airplane::solid,     0,  Airplane::visibility,    Airplane::file_order,    false, false, false, false, false},
+
+        //The grids and the large triangles are added from back to front, the worst order for the depth test
+        {"grid_10k",        grid,            25, 20, 20, Airplane::solid,     0,  Airplane::forward,       Airplane::front_to_back, false, false, false, false, false},
+        {"grid_100k",       grid,            50, 40, 50, Airplane::solid,     0,  Airplane::forward,       Airplane::front_to_back, false, false, false, false, false},
+        {"large_triangles", large_triangles, 0,  0,  0,  Airplane::solid,     0,  Airplane::forward,       Airplane::front_to_back, false, false, false, false, false},
+
+        //The nearest cubes hide the ones behind them
+        {"grid_10k",        grid,            25, 20, 20, Airplane::solid,     0,  Airplane::forward,       Airplane::front_to_back, true, false, false, false, false},
+        {"grid_100k",       grid,            50, 40, 50, Airplane::solid,     0,  Airplane::forward,       Airplane::front_to_back, true, false, false, false, false},
+        {"large_triangles", large_triangles, 0,  0,  0,  Airplane::solid,     0,  Airplane::forward,       Airplane::front_to_back, true, false, false, false, false},
+
+        //Most of the cubes are around the camera but outside of the view
+        {"wide_100k",       wide_grid,       50, 40, 50, Airplane::solid,     0,  Airplane::forward,       Airplane::file_order,    false, false, false, false, false},
+        {"wide_100k",       wide_grid,       50, 40, 50, Airplane::solid,     0,  Airplane::forward,       Airplane::file_order,    false, true, false, false, false},
+        {"grid_100k",       grid,            50, 40, 50, Airplane::solid,     0,  Airplane::forward,       Airplane::file_order,    false, true, false, false, false},
+
+        //Cubes of about one pixel are skipped, the larger ones far away are drawn simpler
+        {"tiny_triangles",  tiny_triangles,  50, 40, 50, Airplane::solid,     0,  Airplane::forward,       Airplane::file_order,    false, false, true, false, false},
+        {"grid_100k",       grid,            50, 40, 50, Airplane::solid,     0,  Airplane::forward,       Airplane::file_order,    false, false, true, false, false},
+
+        //Spheres of 960 faces instead of the cubes, the clusters turned away are skipped
+        {"sphere_1k",       sphere_grid,     10, 10, 10, Airplane::solid,     0,  Airplane::forward,       Airplane::file_order,    false, false, false, false, false},
+        {"sphere_1k",       sphere_grid,     10, 10, 10, Airplane::solid,     0,  Airplane::forward,       Airplane::file_order,    false, false, false, true, false},
+
+        //The cubes and spheres never move, their vertices are transformed to the world once
+        {"grid_10k",        grid,            25, 20, 20, Airplane::solid,     0,  Airplane::forward,       Airplane::file_order,    false, false, false, false, true},
+        {"grid_100k",       grid,            50, 40, 50, Airplane::solid,     0,  Airplane::forward,       Airplane::file_order,    false, false, false, false, true},
+        {"sphere_1k",       sphere_grid,     10, 10, 10, Airplane::solid,     0,  Airplane::forward,       Airplane::file_order,    false, false, false, false, true},
+    };
+
+    const char * SHADING_NAMES[] = { "forward", "visibility", "prepass" };
+    const char * ORDER_NAMES[]   = { "file", "front" };
+
+    const int RESOLUTIONS[][2] = { {640, 480}, {1280, 960}, {1920, 1440}, {3840, 2160} };
+
+    const int WARMUP_FRAMES = 2;
+
+
+    /**
+    * @brief AddCube:   add a cube to the scene
+    */
+    void AddCube(float x, float y, float z, float size)
+    {
+        CS250Parser::Transform cube;
+        cube.name   = "bench";
+        cube.parent = "None";
+        cube.pos    = Point4(x, y, z);
+        cube.rot    = Vector4(0.f, 0.f, 0.f);
+        cube.sca    = Vector4(size, size, size);
+        cube.up     = Vector4(0.f, 1.f, 0.f);
+        cube.fwd    = Vector4(0.f, 0.f, 1.f);
+        cube.right  = Vector4(-1.f, 0.f, 0.f);
+
+        CS250Parser::objects.push_back(cube);
+    }
+
+    /**
+    * @brief AddGrid:   add a grid of nx*ny*nz cubes filling the given box
+    */
+    void AddGrid(int nx, int ny, int nz, float x0, float x1, float y0, float y1, float z0, float z1, float size)
+    {
+        float dx = (x1 - x0) / nx, dy = (y1 - y0) / ny, dz = (z1 - z0) / nz;
+
+        for (int k = 0; k < nz; k++)
+            for (int j = 0; j < ny; j++)
+                for (int i = 0; i < nx; i++)
+                    AddCube(x0 + (i + 0.5f) * dx, y0 + (j + 0.5f) * dy, z0 + (k + 0.5f) * dz, size);
+    }
+
+    /**
+    * @brief SetSphereMesh: replace the cube of input.txt with a sphere of the same size,
+    *                       the faces counterclockwise from the outside
+    */
+    void SetSphereMesh(int rings, int segments)
+    {
+        const float pi = 3.14159265f;
+
+        CS250Parser::vertices.clear();
+        CS250Parser::faces.clear();
+        CS250Parser::colors.clear();
+
+        for (int i = 0; i <= rings; i++)
+        {
+            for (int j = 0; j < segments; j++)
+            {
+                float theta = pi * i / rings, phi = 2.f * pi * j / segments;
+                CS250Parser::vertices.push_back(Point4(0.5f * sinf(theta) * cosf(phi), 0.5f * cosf(theta),
+                                                       0.5f * sinf(theta) * sinf(phi)));
+            }
+        }
+
+        for (int i = 0; i < rings; i++)
+        {
+            for (int j = 0; j < segments; j++)
+            {
+                int a = i * segments + j, b = i * segments + (j + 1) % segments;
+                int c = (i + 1) * segments + (j + 1) % segments, d = (i + 1) * segments + j;
+
+                //The rings at the poles only have one triangle per segment
+                if (i > 0)
+                    CS250Parser::faces.push_back(CS250Parser::Face{ { a, b, c } });
+                if (i < rings - 1)
+                    CS250Parser::faces.push_back(CS250Parser::Face{ { a, c, d } });
+            }
+        }
+
+        for (size_t f = 0; f < CS250Parser::faces.size(); f++)
+            CS250Parser::colors.push_back(Point4(f % 2 ? 200.f : 60.f, 60.f + f % 7 * 30.f, 120.f, 0.f));
+    }
+
+    /**
+    * @brief BuildScene:    replace the boxes of input.txt with the objects of the scene,
+    *                       the airplane is kept since the input and the cameras use it
+    */
+    void BuildScene(const Scene & scene)
+    {
+        if (scene.type == input_scene)
+            return;
+
+        std::vector<CS250Parser::Transform> airplane;
+        for (const CS250Parser::Transform & obj : CS250Parser::objects)
+        {
+            if (obj.name == "body" || obj.parent != "None")
+                airplane.push_back(obj);
+        }
+        CS250Parser::objects = airplane;
+
+        switch (scene.type)
+        {
+        case grid:
+        {
+            //Fill the view of the rooted camera, from near to far
+            float spacing = 160.f / scene.nx;
+            if (120.f / scene.ny < spacing)
+                spacing = 120.f / scene.ny;
+
+            AddGrid(scene.nx, scene.ny, scene.nz, -80.f, 80.f, -60.f, 60.f, -460.f, -100.f, 0.5f * spacing);
+            break;
+        }
+
+        case large_triangles:
+            //Screen filling cubes drawn from back to front: every pixel is written by each of them
+            for (int i = 0; i < 6; i++)
+                AddCube(0.f, 0.f, -450.f + 50.f * i, 180.f);
+            break;
+
+        case tiny_triangles:
+            //Far away cubes of about one pixel
+            AddGrid(scene.nx, scene.ny, scene.nz, -250.f, 250.f, -190.f, 190.f, -480.f, -380.f, 0.4f);
+            break;
+
+        case sphere_grid:
+        {
+            //The same as the grid of 1k cubes
+            SetSphereMesh(16, 32);
+
+            float spacing = 160.f / scene.nx;
+            if (120.f / scene.ny < spacing)
+                spacing = 120.f / scene.ny;
+
+            AddGrid(scene.nx, scene.ny, scene.nz, -80.f, 80.f, -60.f, 60.f, -460.f, -100.f, 0.5f * spacing);
+            break;
+        }
+
+        case wide_grid:
+            //All around the camera and past the far plane, only a small part is in the view
+            AddGrid(scene.nx, scene.ny, scene.nz, -1000.f, 1000.f, -60.f, 60.f, -1000.f, 1000.f, 2.f);
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    /**
+    * @brief RunScene:  render one scene at one resolution with some threads and print its CSV line
+    */
+    void RunScene(const Scene & scene, int width, int height, int frames, int threads)
+    {
+        Airplane airplane(width, height);
+        airplane.Airplane_Initialize();
+
+        BuildScene(scene);
+        airplane.UpdateSceneInfo();
+        airplane.SetDrawMode(scene.mode);
+        airplane.SetTileSize(scene.tiles);
+        airplane.SetShading(scene.shading);
+        airplane.SetDrawOrder(scene.order);
+        airplane.SetOcclusionCulling(scene.occlusion);
+        airplane.SetFrustumCulling(scene.bvh);
+        airplane.SetLevelOfDetail(scene.lod);
+        airplane.SetMeshletCulling(scene.meshlets);
+        airplane.SetStaticBatching(scene.static_batch);
+
+        FrameBuffer::Init(width, height);
+
+        //The window converts every frame for the texture too
+        unsigned char * rgba = FrameBuffer::AllocateRGBA(width, height);
+
+        for (int i = 0; i < WARMUP_FRAMES; i++)
+        {
+            FrameBuffer::Clear(255, 255, 255);
+            airplane.Airplane_Update();
+        }
+
+#ifdef CS250_PROFILE
+        Profiler::Reset();
+#endif
+
+        double total = 0.0, min = 0.0;
+        for (int i = 0; i < frames; i++)
+        {
+            clock::time_point start = clock::now();
+            PROFILE_BEGIN_FRAME();
+
+            {
+                PROFILE_SCOPE(clear);
+                FrameBuffer::Clear(255, 255, 255);
+            }
+            airplane.Airplane_Update();
+            {
+                PROFILE_SCOPE(convert);
+                FrameBuffer::ConvertToRGBA(FrameBuffer::GetBound(), rgba);
+            }
+
+            PROFILE_END_FRAME();
+            double ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+            total += ms;
+            if (i == 0 || ms < min)
+                min = ms;
+        }
+
+        FrameBuffer::ReleaseRGBA(rgba);
+        FrameBuffer::Free();
+
+        //The scenes are static, so the counters of the last frame are the ones of every frame
+        const Rasterizer::Stats & stats = Rasterizer::stats;
+        double avg     = total / frames;
+        double seconds = avg / 1000.0;
+
+        printf("%s,%s,%d,%s,%s,%d,%d,%d,%d,%d,%d,%d,%d,%d,%zu,%.3f,%.3f,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%.3f,%.3f",
+               scene.name, scene.mode == Airplane::wireframe ? "wireframe" : "solid", scene.tiles,
+               SHADING_NAMES[scene.shading], ORDER_NAMES[scene.order], scene.occlusion ? 1 : 0, scene.bvh ? 1 : 0,
+               scene.lod ? 1 : 0, scene.meshlets ? 1 : 0, scene.static_batch ? 1 : 0, width, height, threads, frames, CS250Parser::objects.size(), avg, min,
+               stats.triangles_submitted, stats.triangles_culled, stats.triangles_occluded, stats.triangles_simplified,
+               stats.triangles_rasterized,
+               stats.pixels_tested, stats.pixels_passed, stats.pixels_shaded, stats.prepass_tested,
+               stats.triangles_submitted / seconds / 1e6, stats.pixels_tested / seconds / 1e6);
+
+#ifdef CS250_PROFILE
+        for (int i = 0; i < Profiler::frame; i++)
+        {
+            float stage_min, stage_avg, stage_p99;
+            Profiler::GetStats(static_cast<Profiler::Stage>(i), stage_min, stage_avg, stage_p99);
+            printf(",%.4f", stage_avg);
+        }
+#endif
+
+        printf("\n");
+        fflush(stdout);
+    }
+}
+
+
+/**
+* @brief Run:       render every benchmark scene at every resolution
+*
+* @param frames:        frames measured per scene, resolution and thread count
+* @param max_threads:   most threads of the job system, 0 for one per core
+* @param pin:           keep every worker thread on its own core
+* @return               exit code of the program
+*/
+int Run(int frames, int max_threads, bool pin)
+{
+    if (frames <= 0)
+        frames = 1;
+
+    if (max_threads <= 0)
+        max_threads = static_cast<int>(std::thread::hardware_concurrency());
+    if (max_threads < 1)
+        max_threads = 1;
+
+    //The scenes never change
+    Input::SetMode(Input::none);
+
+    printf("scene,mode,tiles,shading,order,occlusion,bvh,lod,meshlets,static,width,height,threads,frames,objects,ms_avg,ms_min,"
+           "tris_submitted,tris_culled,tris_occluded,tris_simplified,tris_rasterized,pixels_tested,pixels_passed,pixels_shaded,prepass_tested,mtris_s,mpixels_s");
+
+#ifdef CS250_PROFILE
+    //Average time of every stage
+    for (int i = 0; i < Profiler::frame; i++)
+        printf(",%s_ms", Profiler::GetName(static_cast<Profiler::Stage>(i)));
+#endif
+
+    printf("\n");
+
+    for (const Scene & scene : SCENES)
+    {
+        for (const int * size : RESOLUTIONS)
+        {
+            //1, 2, 4... threads and then all of them
+            for (int threads = 1; ; threads = threads * 2 < max_threads ? threads * 2 : max_threads)
+            {
+                fprintf(stderr, "%s %dx%d, %d tiles, %s, %s order%s%s%s%s%s, %d threads...\n", scene.name, size[0], size[1],
+                        scene.tiles, SHADING_NAMES[scene.shading], ORDER_NAMES[scene.order],
+                        scene.occlusion ? ", occlusion" : "", scene.bvh ? ", bvh" : "", scene.lod ? ", lod" : "",
+                        scene.meshlets ? ", meshlets" : "", scene.static_batch ? ", static" : "", threads);
+
+                JobSystem::Init(threads, pin);
+                RunScene(scene, size[0], size[1], frames, threads);
+
+                if (threads == max_threads)
+                    break;
+            }
+        }
+    }
+
+    JobSystem::Shutdown();
+    return 0;
+}
+
+} // namespace Benchmark
@@ -0,0 +1,29 @@
+/****************************************************************************************/
+/*!
+\file   Benchmark.h
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+Rasterizer benchmark: renders fixed synthetic scenes at several resolutions
+without a window and prints one CSV line per run, so that changes to the
+Rasterizer and the FrameBuffer can be compared between builds.
+Functions include:	Run
+
+*/
+/****************************************************************************************/
+
+#pragma once
+
+namespace Benchmark
+{
+
+// Renders every scene at every resolution, measuring the given number of frames each.
+// Every run is repeated with 1, 2, 4... threads up to max_threads (0 for one per core).
+// The results are printed as CSV on stdout and the progress on stderr.
+int Run(int frames, int max_threads = 0, bool pin = false);
+
+} // namespace Benchmark
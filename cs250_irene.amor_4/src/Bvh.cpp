@@ -0,0 +1,344 @@
+/****************************************************************************************/
+/*!
+\file   Bvh.cpp
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+This file contains the implementation of the bounding volume hierarchy.
+Functions include:	Build, Refit, Query, FrustumPlanes, TransformBox,
+					Merge, Center, Split, FitNode, Outside, Inside, Visit
+
+*/
+/****************************************************************************************/
+
+#include "Bvh.h"        //Header file
+#include <algorithm>    //nth_element, min, max
+#include <cfloat>       //FLT_MAX
+
+namespace Bvh
+{
+
+namespace
+{
+    const Box EMPTY = { { FLT_MAX, FLT_MAX, FLT_MAX }, { -FLT_MAX, -FLT_MAX, -FLT_MAX } };
+
+    const unsigned ALL_PLANES = (1u << 6) - 1;
+
+
+    /**
+    * @brief Merge: grow a box to contain another one
+    */
+    void Merge(Box & box, const Box & other)
+    {
+        for (int axis = 0; axis < 3; axis++)
+        {
+            box.min[axis] = std::min(box.min[axis], other.min[axis]);
+            box.max[axis] = std::max(box.max[axis], other.max[axis]);
+        }
+    }
+
+    /**
+    * @brief Center: twice the center of a box along an axis, only compared
+    */
+    float Center(const Box & box, int axis)
+    {
+        return box.min[axis] + box.max[axis];
+    }
+
+    /**
+    * @brief Split:     add the node of a range of the object list and the nodes below it
+    *
+    * @param tree:      tree with the boxes of the objects
+    * @param first:     first object of the range
+    * @param count:     objects of the range
+    * @param parent:    node above, -1 for the root
+    */
+    void Split(Tree & tree, int first, int count, int parent)
+    {
+        const int index = static_cast<int>(tree.nodes.size());
+        tree.nodes.push_back(Node{ EMPTY, parent, -1, first, count });
+
+        int * objects = &tree.objects[first];
+        if (count <= LEAF_OBJECTS)
+        {
+            for (int i = 0; i < count; i++)
+            {
+                Merge(tree.nodes[index].box, tree.boxes[objects[i]]);
+                tree.leaf_of[objects[i]] = index;
+            }
+            return;
+        }
+
+        //Halves along the longest side of the centers of the objects
+        Box centers = EMPTY;
+        for (int i = 0; i < count; i++)
+        {
+            const Box & box = tree.boxes[objects[i]];
+            for (int axis = 0; axis < 3; axis++)
+            {
+                centers.min[axis] = std::min(centers.min[axis], Center(box, axis));
+                centers.max[axis] = std::max(centers.max[axis], Center(box, axis));
+            }
+        }
+
+        int axis = 0;
+        for (int i = 1; i < 3; i++)
+        {
+            if (centers.max[i] - centers.min[i] > centers.max[axis] - centers.min[axis])
+                axis = i;
+        }
+
+        const int half = count / 2;
+        std::nth_element(objects, objects + half, objects + count, [&tree, axis](int a, int b)
+        {
+            return Center(tree.boxes[a], axis) < Center(tree.boxes[b], axis);
+        });
+
+        //The first child is the next node, the second one goes after all the nodes of the first
+        Split(tree, first, half, index);
+        tree.nodes[index].right = static_cast<int>(tree.nodes.size());
+        Split(tree, first + half, count - half, index);
+
+        Node & node = tree.nodes[index];
+        node.box = tree.nodes[index + 1].box;
+        Merge(node.box, tree.nodes[node.right].box);
+    }
+
+    /**
+    * @brief FitNode:   box of a node from the boxes below it
+    *
+    * @param tree:      tree with the right boxes below the node
+    * @param index:     node to fit
+    * @return           whether the box of the node changed
+    */
+    bool FitNode(Tree & tree, int index)
+    {
+        Node & node = tree.nodes[index];
+        Box box = EMPTY;
+
+        if (node.right < 0)
+        {
+            for (int i = 0; i < node.count; i++)
+                Merge(box, tree.boxes[tree.objects[node.first + i]]);
+        }
+        else
+        {
+            box = tree.nodes[index + 1].box;
+            Merge(box, tree.nodes[node.right].box);
+        }
+
+        for (int axis = 0; axis < 3; axis++)
+        {
+            if (box.min[axis] != node.box.min[axis] || box.max[axis] != node.box.max[axis])
+            {
+                node.box = box;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+    * @brief Outside: whether a box is completely on the outer side of a plane
+    */
+    bool Outside(const Box & box, const Plane & plane)
+    {
+        //The corner that goes the farthest to the inner side
+        return plane.a * (plane.a >= 0.f ? box.max[0] : box.min[0]) +
+               plane.b * (plane.b >= 0.f ? box.max[1] : box.min[1]) +
+               plane.c * (plane.c >= 0.f ? box.max[2] : box.min[2]) + plane.d < 0.f;
+    }
+
+    /**
+    * @brief Inside: whether a box is completely on the inner side of a plane
+    */
+    bool Inside(const Box & box, const Plane & plane)
+    {
+        //The corner that goes the farthest to the outer side
+        return plane.a * (plane.a >= 0.f ? box.min[0] : box.max[0]) +
+               plane.b * (plane.b >= 0.f ? box.min[1] : box.max[1]) +
+               plane.c * (plane.c >= 0.f ? box.min[2] : box.max[2]) + plane.d >= 0.f;
+    }
+
+    /**
+    * @brief Visit:     add the objects of a node that are not outside of the frustum
+    *
+    * @param tree:      tree to query
+    * @param frustum:   planes of the frustum
+    * @param index:     node to visit
+    * @param planes:    planes the parent was not completely inside of, one bit each
+    * @param visible:   list the objects are added to
+    */
+    void Visit(const Tree & tree, const Frustum & frustum, int index, unsigned planes, std::vector<int> & visible)
+    {
+        const Node & node = tree.nodes[index];
+
+        for (int i = 0; i < 6; i++)
+        {
+            if (!(planes & (1u << i)))
+                continue;
+
+            if (Outside(node.box, frustum.planes[i]))
+                return;
+            if (Inside(node.box, frustum.planes[i]))
+                planes &= ~(1u << i);
+        }
+
+        //Completely inside, all the objects below are taken without more tests
+        if (planes == 0)
+        {
+            visible.insert(visible.end(), tree.objects.begin() + node.first,
+                           tree.objects.begin() + node.first + node.count);
+            return;
+        }
+
+        //The objects of a leaf are tested on their own against the planes left
+        if (node.right < 0)
+        {
+            for (int i = 0; i < node.count; i++)
+            {
+                int  obj     = tree.objects[node.first + i];
+                bool outside = false;
+                for (int plane = 0; plane < 6 && !outside; plane++)
+                    outside = (planes & (1u << plane)) && Outside(tree.boxes[obj], frustum.planes[plane]);
+
+                if (!outside)
+                    visible.push_back(obj);
+            }
+            return;
+        }
+
+        Visit(tree, frustum, index + 1, planes, visible);
+        Visit(tree, frustum, node.right, planes, visible);
+    }
+}
+
+
+/**
+* @brief Build:     build the tree over the boxes of the objects, the objects below
+*                   every node are together in the object list
+*
+* @param tree:      tree to build, anything in it is replaced
+* @param boxes:     world box of every object
+*/
+void Build(Tree & tree, const std::vector<Box> & boxes)
+{
+    const int count = static_cast<int>(boxes.size());
+
+    tree.boxes = boxes;
+    tree.nodes.clear();
+    tree.nodes.reserve(count > 0 ? 2 * (count / LEAF_OBJECTS + 1) : 0);
+    tree.leaf_of.assign(count, -1);
+    tree.objects.resize(count);
+    for (int obj = 0; obj < count; obj++)
+        tree.objects[obj] = obj;
+
+    if (count > 0)
+        Split(tree, 0, count, -1);
+}
+
+/**
+* @brief Refit:     give some objects their new boxes and fit the nodes from their leaves up
+*                   to the root, stopping at the first node that does not change. The nodes
+*                   are not split again, so the tree gets worse if the objects move far
+*
+* @param tree:      tree to refit
+* @param changed:   objects with new boxes
+* @param boxes:     world box of every object
+*/
+void Refit(Tree & tree, const std::vector<int> & changed, const std::vector<Box> & boxes)
+{
+    //Most of the objects: every node once, the children are after their parents
+    if (changed.size() * 4 > tree.boxes.size())
+    {
+        tree.boxes = boxes;
+        for (int index = static_cast<int>(tree.nodes.size()) - 1; index >= 0; index--)
+            FitNode(tree, index);
+        return;
+    }
+
+    for (int obj : changed)
+    {
+        tree.boxes[obj] = boxes[obj];
+
+        //The nodes above were right before this object moved
+        for (int index = tree.leaf_of[obj]; index >= 0 && FitNode(tree, index); index = tree.nodes[index].parent)
+            ;
+    }
+}
+
+/**
+* @brief Query:     add the objects whose boxes touch the frustum, in the order of the tree
+*
+* @param tree:      tree to query
+* @param frustum:   planes of the frustum
+* @param visible:   list the objects are added to
+*/
+void Query(const Tree & tree, const Frustum & frustum, std::vector<int> & visible)
+{
+    if (!tree.nodes.empty())
+        Visit(tree, frustum, 0, ALL_PLANES, visible);
+}
+
+/**
+* @brief FrustumPlanes: planes of a frustum in the space the matrix transforms from
+*
+* @param clip:          matrix to the clip coordinates
+* @param x_limit:       largest x / w inside
+* @param y_limit:       largest y / w inside
+* @param near:          smallest z inside
+* @return               left, right, bottom, top, near and far planes
+*/
+Frustum FrustumPlanes(const Matrix4 & clip, float x_limit, float y_limit, float near)
+{
+    //Every clip coordinate is a row of the matrix times the point
+    auto row = [&clip](int i, float scale)
+    {
+        return Plane{ clip.m[i][0] * scale, clip.m[i][1] * scale, clip.m[i][2] * scale, clip.m[i][3] * scale };
+    };
+    auto add = [](const Plane & a, const Plane & b)
+    {
+        return Plane{ a.a + b.a, a.b + b.b, a.c + b.c, a.d + b.d };
+    };
+
+    Frustum frustum;
+    frustum.planes[0] = add(row(3, x_limit), row(0, 1.f));      // x >= -x_limit * w
+    frustum.planes[1] = add(row(3, x_limit), row(0, -1.f));     // x <= x_limit * w
+    frustum.planes[2] = add(row(3, y_limit), row(1, 1.f));
+    frustum.planes[3] = add(row(3, y_limit), row(1, -1.f));
+    frustum.planes[4] = row(2, 1.f);                            // z >= -near
+    frustum.planes[4].d += near;
+    frustum.planes[5] = add(row(3, 1.f), row(2, -1.f));         // z <= w
+    return frustum;
+}
+
+/**
+* @brief TransformBox:  box around the corners of a box moved by a matrix
+*
+* @param box:           box of a mesh
+* @param transform:     model to world of the object
+* @return               world box of the object
+*/
+Box TransformBox(const Box & box, const Matrix4 & transform)
+{
+    //Every row of the matrix takes the smallest and largest product of each axis
+    Box result;
+    for (int i = 0; i < 3; i++)
+    {
+        result.min[i] = result.max[i] = transform.m[i][3];
+        for (int axis = 0; axis < 3; axis++)
+        {
+            float a = transform.m[i][axis] * box.min[axis];
+            float b = transform.m[i][axis] * box.max[axis];
+            result.min[i] += std::min(a, b);
+            result.max[i] += std::max(a, b);
+        }
+    }
+    return result;
+}
+
+} // namespace Bvh
@@ -0,0 +1,81 @@
+/****************************************************************************************/
+/*!
+\file   Bvh.h
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+Bounding volume hierarchy over the world boxes of the objects of the scene.
+It is built once, splitting the objects in halves along the longest side of
+their centers, and refit when some objects move: only the boxes from the
+leaves of those objects up to the root change. The frustum queries skip whole
+subtrees outside of a plane and take whole subtrees inside of all of them.
+Functions include:	Build, Refit, Query, FrustumPlanes, TransformBox
+
+*/
+/****************************************************************************************/
+
+#pragma once
+
+#include "Math/Matrix4.h"
+#include <vector>
+
+namespace Bvh
+{
+
+const int LEAF_OBJECTS = 4;     // most objects of a leaf
+
+struct Box
+{
+    float min[3];
+    float max[3];
+};
+
+// a*x + b*y + c*z + d >= 0 inside
+struct Plane
+{
+    float a, b, c, d;
+};
+
+struct Frustum
+{
+    Plane planes[6];
+};
+
+struct Node
+{
+    Box box;
+    int parent;         // -1 for the root
+    int right;          // second child, the first one is the next node. -1 for a leaf
+    int first;          // objects below the node in the object list
+    int count;
+};
+
+struct Tree
+{
+    std::vector<Node> nodes;        // every node before its children
+    std::vector<int>  objects;      // objects of the leaves, in leaf order
+    std::vector<int>  leaf_of;      // leaf of every object
+    std::vector<Box>  boxes;        // world box of every object
+};
+
+// Build the tree over the boxes of every object
+void Build(Tree & tree, const std::vector<Box> & boxes);
+
+// Give some objects new boxes and fix the boxes of the nodes above them
+void Refit(Tree & tree, const std::vector<int> & changed, const std::vector<Box> & boxes);
+
+// Add the objects whose boxes are not completely outside of a plane of the frustum
+void Query(const Tree & tree, const Frustum & frustum, std::vector<int> & visible);
+
+// Planes of the points whose clip coordinates by the matrix have |x| <= x_limit * w,
+// |y| <= y_limit * w, z >= -near and z <= w
+Frustum FrustumPlanes(const Matrix4 & clip, float x_limit, float y_limit, float near);
+
+// Box around the box of a mesh moved by a matrix
+Box TransformBox(const Box & box, const Matrix4 & transform);
+
+} // namespace Bvh
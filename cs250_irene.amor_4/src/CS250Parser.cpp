@@ -1,4 +1,6 @@
 #include "CS250Parser.h"
+#include "Platform.h"
+#include <cstdlib>
 
 float   CS250Parser::left;
 float   CS250Parser::right;
@@ -109,16 +111,16 @@ void CS250Parser::LoadDataFromFile(const char * filename)
         Transform transform;
         char      name[512]   = {0};
         char      parent[512] = {0};
-        fscanf_s(in, "\t%s = ",
-                 name, 512);
+        fscanf_s(in, "\t%511s = ",
+                 SCANF_BUFFER(name, sizeof(name)));
         fscanf_s(in, "T(%f,%f,%f), ",
                  &transform.pos.x, &transform.pos.y, &transform.pos.z);
         fscanf_s(in, "R(%f,%f,%f), ",
                  &transform.rot.x, &transform.rot.y, &transform.rot.z);
         fscanf_s(in, "S(%f,%f,%f), ",
                  &transform.sca.x, &transform.sca.y, &transform.sca.z);
-        fscanf_s(in, "%s\n",
-                 parent, 512);
+        fscanf_s(in, "%511s\n",
+                 SCANF_BUFFER(parent, sizeof(parent)));
         transform.name = name;
         transform.parent = parent;
         
@@ -0,0 +1,114 @@
+/****************************************************************************************/
+/*!
+\file   CameraPath.cpp
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+This file contains the implementation of the scripted camera path.
+Functions include:	Load, GetLength, Sample
+
+*/
+/****************************************************************************************/
+
+#include "CameraPath.h"     //Header file
+#include "Platform.h"       //fopen_s outside of MSVC
+
+std::vector<CameraPath::Key> CameraPath::keys;
+
+
+/**
+* @brief Load:      read the keyframes of the camera path
+*
+* @param filename:  file with the keyframes
+* @return           whether at least one keyframe was read
+*/
+bool CameraPath::Load(const char * filename)
+{
+    keys.clear();
+
+    FILE * in = nullptr;
+    fopen_s(&in, filename, "r");
+    if (!in)
+    {
+        std::fprintf(stderr, "Could not open camera path %s\n", filename);
+        return false;
+    }
+
+    char line[512];
+    while (fgets(line, sizeof(line), in))
+    {
+        if (line[0] == '#')
+            continue;
+
+        Key key;
+        int read = sscanf_s(line, "%f %f,%f,%f %f,%f,%f %f,%f,%f",
+                            &key.frame,
+                            &key.position.x, &key.position.y, &key.position.z,
+                            &key.view.x, &key.view.y, &key.view.z,
+                            &key.up.x, &key.up.y, &key.up.z);
+        if (read == 10)
+            keys.push_back(key);
+    }
+    fclose(in);
+
+    if (keys.empty())
+        std::fprintf(stderr, "Camera path %s has no keyframes\n", filename);
+
+    return !keys.empty();
+}
+
+/**
+* @brief GetLength: number of frames until the last keyframe
+*
+* @return           frame of the last keyframe plus one
+*/
+unsigned CameraPath::GetLength()
+{
+    if (keys.empty())
+        return 0;
+
+    return static_cast<unsigned>(keys.back().frame) + 1;
+}
+
+/**
+* @brief Sample:        interpolate the camera at the given frame
+*
+* @param frame:         frame to sample, clamped to the first and last keyframes
+* @param position:      camera position
+* @param view:          camera view vector
+* @param up:            camera up vector
+*/
+void CameraPath::Sample(float frame, Point4 & position, Vector4 & view, Vector4 & up)
+{
+    if (keys.empty())
+        return;
+
+    //Find the keyframes around the frame
+    size_t next = 0;
+    while (next < keys.size() && keys[next].frame <= frame)
+        next++;
+
+    if (next == 0 || next == keys.size())
+    {
+        const Key & key = keys[next == 0 ? 0 : keys.size() - 1];
+        position = key.position;
+        view     = key.view;
+        up       = key.up;
+        return;
+    }
+
+    const Key & k0 = keys[next - 1];
+    const Key & k1 = keys[next];
+    float t = (frame - k0.frame) / (k1.frame - k0.frame);
+
+    //Linear interpolation, the vectors are normalized again
+    position = k0.position + (k1.position - k0.position) * t;
+    view     = k0.view + (k1.view - k0.view) * t;
+    up       = k0.up + (k1.up - k0.up) * t;
+    view.Normalize();
+    up.Normalize();
+}
@@ -0,0 +1,45 @@
+/****************************************************************************************/
+/*!
+\file   CameraPath.h
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+Scripted camera path: keyframes of camera position, view and up vectors that are
+interpolated per frame, so the camera follows the same path on every run.
+Each line of the file is "frame px,py,pz vx,vy,vz ux,uy,uz", lines starting
+with # are ignored and the keyframes must be sorted by frame.
+Functions include:	Load, IsLoaded, GetLength, Sample
+
+*/
+/****************************************************************************************/
+
+#pragma once
+
+#include "Math/Point4.h"
+#include "Math/Vector4.h"
+#include <vector>
+
+class CameraPath
+{
+  public:
+    static bool     Load(const char * filename);
+    static bool     IsLoaded() { return !keys.empty(); }
+    static unsigned GetLength();
+
+    static void Sample(float frame, Point4 & position, Vector4 & view, Vector4 & up);
+
+  private:
+    struct Key
+    {
+        float   frame;
+        Point4  position;
+        Vector4 view;
+        Vector4 up;
+    };
+
+    static std::vector<Key> keys;
+};
@@ -0,0 +1,132 @@
+/****************************************************************************************/
+/*!
+\file   DrawList.cpp
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+This file contains the implementation of the sorted draw lists.
+Functions include:	DepthKey, Sort, InsertionSort, RadixSort
+
+*/
+/****************************************************************************************/
+
+#include "DrawList.h"   //Header file
+#include <cstring>      //memcpy
+
+namespace DrawList
+{
+
+namespace
+{
+    const size_t RADIX_MIN  = 64;       //Fewer draws are sorted by insertion
+    const int    RADIX_BITS = 8;        //Bits of the key sorted by each pass
+    const int    BUCKETS    = 1 << RADIX_BITS;
+    const int    PASSES     = 32 / RADIX_BITS;
+
+
+    /**
+    * @brief InsertionSort: stable sort of a short list
+    *
+    * @param draws:         list to sort
+    */
+    void InsertionSort(std::vector<Draw> & draws)
+    {
+        for (size_t i = 1; i < draws.size(); i++)
+        {
+            Draw   draw = draws[i];
+            size_t j    = i;
+
+            for (; j > 0 && draws[j - 1].key > draw.key; j--)
+                draws[j] = draws[j - 1];
+
+            draws[j] = draw;
+        }
+    }
+
+    /**
+    * @brief RadixSort: stable sort, one byte of the keys at a time from the lowest one
+    *
+    * @param draws:     list to sort
+    * @param scratch:   list of the same size
+    */
+    void RadixSort(std::vector<Draw> & draws, std::vector<Draw> & scratch)
+    {
+        //Counts of every byte of the keys, all of them in one read of the list
+        size_t counts[PASSES][BUCKETS] = {};
+        for (const Draw & draw : draws)
+        {
+            for (int pass = 0; pass < PASSES; pass++)
+                counts[pass][(draw.key >> (pass * RADIX_BITS)) & (BUCKETS - 1)]++;
+        }
+
+        Draw * source = draws.data();
+        Draw * target = scratch.data();
+        for (int pass = 0; pass < PASSES; pass++)
+        {
+            //Every key has the same byte, the pass would not move anything
+            size_t * count = counts[pass];
+            if (count[(source[0].key >> (pass * RADIX_BITS)) & (BUCKETS - 1)] == draws.size())
+                continue;
+
+            //First position of every bucket
+            size_t offset = 0;
+            for (int bucket = 0; bucket < BUCKETS; bucket++)
+            {
+                size_t size   = count[bucket];
+                count[bucket] = offset;
+                offset       += size;
+            }
+
+            for (size_t i = 0; i < draws.size(); i++)
+                target[count[(source[i].key >> (pass * RADIX_BITS)) & (BUCKETS - 1)]++] = source[i];
+
+            Draw * swap = source;
+            source = target;
+            target = swap;
+        }
+
+        //An odd number of passes left the list in the scratch
+        if (source != draws.data())
+            std::memcpy(draws.data(), source, draws.size() * sizeof(Draw));
+    }
+}
+
+
+/**
+* @brief DepthKey:  key of a distance, the smaller distances get the smaller keys
+*
+* @param distance:  distance from the camera
+* @return           key of the distance
+*/
+unsigned DepthKey(float distance)
+{
+    unsigned bits;
+    std::memcpy(&bits, &distance, sizeof(bits));
+
+    //The positive floats sort as their bits, the negative ones in reverse and before them
+    return bits & 0x80000000u ? ~bits : bits | 0x80000000u;
+}
+
+/**
+* @brief Sort:      sort the draws by key, the draws with the same key keep their order
+*
+* @param draws:     list to sort
+* @param scratch:   memory for the radix sort, kept between the frames
+*/
+void Sort(std::vector<Draw> & draws, std::vector<Draw> & scratch)
+{
+    if (draws.size() < RADIX_MIN)
+    {
+        InsertionSort(draws);
+        return;
+    }
+
+    scratch.resize(draws.size());
+    RadixSort(draws, scratch);
+}
+
+} // namespace DrawList
@@ -0,0 +1,41 @@
+/****************************************************************************************/
+/*!
+\file   DrawList.h
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+Order in which the objects of a view are drawn. Every draw has a key, the
+distance from the camera turned into an unsigned integer that sorts the same
+way, and the draws are sorted by it so the nearest objects fill the depth
+buffer first and most pixels of the ones behind fail the depth test.
+Large lists are sorted with a radix sort, small ones with an insertion sort,
+both keep the order of the draws with the same key.
+Functions include:	DepthKey, Sort
+
+*/
+/****************************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+namespace DrawList
+{
+
+struct Draw
+{
+    unsigned key;       // smaller is drawn first
+    int      object;
+};
+
+// Key of a distance from the camera, any float including negative ones
+unsigned DepthKey(float distance);
+
+// Sort the draws by key, scratch gets resized to the size of the list
+void Sort(std::vector<Draw> & draws, std::vector<Draw> & scratch);
+
+} // namespace DrawList
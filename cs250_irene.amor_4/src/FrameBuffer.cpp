@@ -1,65 +1,268 @@
 #include "FrameBuffer.h"
+#include "JobSystem.h"
+#include "Platform.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
 
-int             FrameBuffer::width     = 0;
-int             FrameBuffer::height    = 0;
-unsigned char * FrameBuffer::imageData = nullptr;
-float         * FrameBuffer::DepthBuffer = nullptr;
+#ifndef CS250_HEADLESS
+#include <SFML/Graphics/Image.hpp>
+#endif
+
+FrameBuffer::Buffer                FrameBuffer::default_buffer;
+thread_local FrameBuffer::Buffer * FrameBuffer::bound     = &FrameBuffer::default_buffer;
+thread_local int             FrameBuffer::width     = 0;
+thread_local int             FrameBuffer::height    = 0;
+thread_local int             FrameBuffer::originX   = 0;
+thread_local int             FrameBuffer::originY   = 0;
+thread_local unsigned char * FrameBuffer::imageData = nullptr;
+thread_local float         * FrameBuffer::DepthBuffer = nullptr;
+thread_local unsigned char * FrameBuffer::OverdrawBuffer = nullptr;
+thread_local bool            FrameBuffer::overdraw  = false;
+thread_local FrameBuffer::Scissor FrameBuffer::scissor = {0, 0, INT_MAX, INT_MAX};
+
+namespace
+{
+    // The buffers start on a cache line and the bands are whole blocks of pixels,
+    // so no two threads ever write to the same cache line of any of the planes
+    const size_t CACHE_LINE  = 64;
+    const int    BAND_BLOCK  = 64;          // pixels, a whole number of lines of 1, 3 and 4 bytes per pixel
+    const int    BAND_PIXELS = 64 * 1024;   // pixels of a band at least
+
+    // Run body(first, last) over bands of the pixels [0, pixels) on the job system
+    template <typename Body>
+    void ForEachBand(int pixels, const Body & body)
+    {
+        int blocks = (pixels + BAND_BLOCK - 1) / BAND_BLOCK;
+
+        JobSystem::ParallelFor(0, blocks, BAND_PIXELS / BAND_BLOCK, [pixels, &body](int first, int last)
+        {
+            int end = last * BAND_BLOCK;
+            body(first * BAND_BLOCK, end < pixels ? end : pixels);
+        });
+    }
+}
 
 void FrameBuffer::Init(int w, int h)
 {
-    width     = w;
-    height    = h;
-    int size  = 3 * width * height;
-    imageData = new unsigned char[size];
-    DepthBuffer = new float[size/3];
+    Allocate(default_buffer, w, h);
+    Bind(default_buffer);
 }
 
 void FrameBuffer::Free()
 {
-    delete[] imageData;
-    delete[] DepthBuffer;
+    Release(default_buffer);
+    Bind(default_buffer);
+}
+
+// Allocate the memory of a buffer, it is not bound
+void FrameBuffer::Allocate(Buffer & buffer, int w, int h)
+{
+    buffer.width    = w;
+    buffer.height   = h;
+    size_t pixels   = static_cast<size_t>(w) * h;
+    buffer.color    = static_cast<unsigned char *>(_aligned_malloc(3 * pixels, CACHE_LINE));
+    buffer.depth    = static_cast<float *>(_aligned_malloc(pixels * sizeof(float), CACHE_LINE));
+    buffer.overdraw = static_cast<unsigned char *>(_aligned_malloc(pixels, CACHE_LINE));
+    buffer.ids      = static_cast<unsigned *>(_aligned_malloc(pixels * sizeof(unsigned), CACHE_LINE));
+    std::memset(buffer.overdraw, 0, pixels);
+    std::memset(buffer.ids, 0, pixels * sizeof(unsigned));
+}
+
+void FrameBuffer::Release(Buffer & buffer)
+{
+    _aligned_free(buffer.color);
+    _aligned_free(buffer.depth);
+    _aligned_free(buffer.overdraw);
+    _aligned_free(buffer.ids);
+
+    buffer = Buffer();
 }
 
+// Draw to a buffer from now on, on the calling thread
+void FrameBuffer::Bind(Buffer & buffer)
+{
+    bound          = &buffer;
+    width          = buffer.width;
+    height         = buffer.height;
+    originX        = buffer.x;
+    originY        = buffer.y;
+    imageData      = buffer.color;
+    DepthBuffer    = buffer.depth;
+    OverdrawBuffer = buffer.overdraw;
+    overdraw       = buffer.counting;
+}
+
+// Clear the bound buffer, in bands split between the threads of the job system
 void FrameBuffer::Clear(unsigned char r, unsigned char g, unsigned char b)
 {
-    for (int x = 0; x < width; x++)
+    // The bands can run on any thread, which may have another buffer bound
+    unsigned char * colors = imageData;
+    float         * depths = DepthBuffer;
+    unsigned char * counts = overdraw ? OverdrawBuffer : nullptr;
+
+    ForEachBand(width * height, [r, g, b, colors, depths, counts](int first, int last)
     {
-        for (int y = 0; y < height; y++)
+        unsigned char * color = colors + 3 * first;
+        int             count = last - first;
+
+        if (r == g && g == b)
+            std::memset(color, r, 3 * count);
+        else
         {
-            imageData[(y * width + x) * 3 + 0] = r;
-            imageData[(y * width + x) * 3 + 1] = g;
-            imageData[(y * width + x) * 3 + 2] = b;
+            for (int i = 0; i < count; i++)
+            {
+                color[3 * i + 0] = r;
+                color[3 * i + 1] = g;
+                color[3 * i + 2] = b;
+            }
+        }
+
+        std::fill(depths + first, depths + last, 1.f);
+
+        if (counts)
+            std::memset(counts + first, 0, count);
+    });
+}
+
+// Clear a rectangle of the bound buffer, on the calling thread
+void FrameBuffer::Clear(int x, int y, int w, int h, unsigned char r, unsigned char g, unsigned char b)
+{
+    int x0 = x < 0 ? 0 : x,     x1 = x + w > width  ? width  : x + w;
+    int y0 = y < 0 ? 0 : y,     y1 = y + h > height ? height : y + h;
+
+    for (int row = y0; row < y1; row++)
+    {
+        for (int col = x0; col < x1; col++)
+        {
+            int pixel = row * width + col;
+
+            imageData[3 * pixel + 0] = r;
+            imageData[3 * pixel + 1] = g;
+            imageData[3 * pixel + 2] = b;
 
-            DepthBuffer[(y * width + x)] = 1.f;
+            DepthBuffer[pixel] = 1.f;
+            if (overdraw)
+                OverdrawBuffer[pixel] = 0;
         }
     }
 }
 
-void FrameBuffer::SetPixel(int x, int y, float z, unsigned char r, unsigned char g, unsigned char b)
+bool FrameBuffer::SetPixel(int x, int y, float z, unsigned char r, unsigned char g, unsigned char b)
 {
     // Sanity check
-    if (imageData == nullptr || width <= x || x < 0 || height <= y || y < 0 || z < -1 || z > 1)
-        return;
+    if (imageData == nullptr || x < scissor.left || y < scissor.top ||
+        x >= scissor.right || y >= scissor.bottom || z < -1 || z > 1)
+        return false;
+
+    // to the pixels of the bound buffer, which may be a tile of the screen
+    x -= originX;
+    y -= originY;
+    if (x < 0 || width <= x || y < 0 || height <= y)
+        return false;
 
     // advance to pixel
     unsigned offset = 3 * (y * width + x);
 
     //set z value
     if (z > DepthBuffer[offset/3])
-        return;
+        return false;
 
     DepthBuffer[offset / 3] = z;
 
+    if (overdraw && OverdrawBuffer[offset / 3] < 255)
+        OverdrawBuffer[offset / 3]++;
+
     // set
     imageData[offset] = r;
     imageData[offset + 1] = g;
     imageData[offset + 2] = b;
+
+    return true;
+}
+
+// Same as SetPixel, for the visibility buffer
+bool FrameBuffer::SetId(int x, int y, float z, unsigned id)
+{
+    // Sanity check
+    if (imageData == nullptr || x < scissor.left || y < scissor.top ||
+        x >= scissor.right || y >= scissor.bottom || z < -1 || z > 1)
+        return false;
+
+    x -= originX;
+    y -= originY;
+    if (x < 0 || width <= x || y < 0 || height <= y)
+        return false;
+
+    unsigned pixel = y * width + x;
+    if (z > DepthBuffer[pixel])
+        return false;
+
+    DepthBuffer[pixel] = z;
+
+    if (overdraw && OverdrawBuffer[pixel] < 255)
+        OverdrawBuffer[pixel]++;
+
+    bound->ids[pixel] = id;
+    return true;
+}
+
+// Same as SetPixel, for the depth prepass
+bool FrameBuffer::SetDepth(int x, int y, float z)
+{
+    // Sanity check
+    if (imageData == nullptr || x < scissor.left || y < scissor.top ||
+        x >= scissor.right || y >= scissor.bottom || z < -1 || z > 1)
+        return false;
+
+    x -= originX;
+    y -= originY;
+    if (x < 0 || width <= x || y < 0 || height <= y)
+        return false;
+
+    unsigned pixel = y * width + x;
+    if (z > DepthBuffer[pixel])
+        return false;
+
+    DepthBuffer[pixel] = z;
+    return true;
+}
+
+// Color pass after the depth prepass: the depth is already final, only the
+// triangles that have that same depth at the pixel write their color
+bool FrameBuffer::SetPixelIfEqual(int x, int y, float z, unsigned char r, unsigned char g, unsigned char b)
+{
+    // Sanity check
+    if (imageData == nullptr || x < scissor.left || y < scissor.top ||
+        x >= scissor.right || y >= scissor.bottom || z < -1 || z > 1)
+        return false;
+
+    x -= originX;
+    y -= originY;
+    if (x < 0 || width <= x || y < 0 || height <= y)
+        return false;
+
+    unsigned pixel = y * width + x;
+    if (z != DepthBuffer[pixel])
+        return false;
+
+    if (overdraw && OverdrawBuffer[pixel] < 255)
+        OverdrawBuffer[pixel]++;
+
+    imageData[3 * pixel]     = r;
+    imageData[3 * pixel + 1] = g;
+    imageData[3 * pixel + 2] = b;
+
+    return true;
 }
 
 void FrameBuffer::GetPixel(int x, int y, float& z, unsigned char & r, unsigned char & g, unsigned char & b)
 {
+    x -= originX;
+    y -= originY;
+
     // Sanity check
-    if (imageData == nullptr || width <= x || height <= y)
+    if (imageData == nullptr || x < 0 || width <= x || y < 0 || height <= y)
     {
         r = 250;
         g = 250;
@@ -79,20 +282,172 @@ void FrameBuffer::GetPixel(int x, int y, float& z, unsigned char & r, unsigned c
     z = DepthBuffer[y * width + x];
 }
 
+#ifndef CS250_HEADLESS
 // Convert the custom framebuffer to SFML format
 void FrameBuffer::ConvertFrameBufferToSFMLImage(sf::Image & image)
 {
-    int w = FrameBuffer::GetWidth();
-    int h = FrameBuffer::GetHeight();
+    ConvertFrameBufferToSFMLImage(*bound, image);
+}
+
+// Convert any buffer to SFML format, it does not need to be bound
+void FrameBuffer::ConvertFrameBufferToSFMLImage(const Buffer & buffer, sf::Image & image)
+{
+    unsigned char * rgba = AllocateRGBA(buffer.width, buffer.height);
+    ConvertToRGBA(buffer, rgba);
 
-    for (int x = 0; x < w; x++)
+    image.create(buffer.width, buffer.height, rgba);
+    ReleaseRGBA(rgba);
+}
+#endif
+
+// Memory for the RGBA pixels of a buffer. It starts on a cache line like the planes, so the
+// bands of ConvertToRGBA don't share any line either
+unsigned char * FrameBuffer::AllocateRGBA(int w, int h)
+{
+    return static_cast<unsigned char *>(_aligned_malloc(4 * static_cast<size_t>(w) * h, CACHE_LINE));
+}
+
+void FrameBuffer::ReleaseRGBA(unsigned char * rgba)
+{
+    _aligned_free(rgba);
+}
+
+// Expand the colors of a buffer to RGBA, in bands split between the threads of the job system.
+// The target comes from AllocateRGBA
+void FrameBuffer::ConvertToRGBA(const Buffer & buffer, unsigned char * rgba)
+{
+    const unsigned char * color = buffer.color;
+
+    ForEachBand(buffer.width * buffer.height, [color, rgba](int first, int last)
     {
-        for (int y = 0; y < h; y++)
+        for (int i = first; i < last; i++)
         {
-            unsigned char r, b, g;
-            float z;
-            FrameBuffer::GetPixel(x, y, z, r, g, b);
-            image.setPixel(x, y, sf::Color(r, g, b));
+            rgba[4 * i + 0] = color[3 * i + 0];
+            rgba[4 * i + 1] = color[3 * i + 1];
+            rgba[4 * i + 2] = color[3 * i + 2];
+            rgba[4 * i + 3] = 255;
         }
+    });
+}
+
+// Write the framebuffer as a binary PPM (P6) image, no windowing required
+bool FrameBuffer::WritePPM(FILE * out)
+{
+    return WritePPM(*bound, out);
+}
+
+// Write any buffer as a binary PPM (P6) image, it does not need to be bound.
+// The comment goes in the header, where any PPM reader skips it
+bool FrameBuffer::WritePPM(const Buffer & buffer, FILE * out, const char * comment)
+{
+    if (buffer.color == nullptr || out == nullptr)
+        return false;
+
+    if (comment)
+        std::fprintf(out, "P6\n# %s\n%d %d\n255\n", comment, buffer.width, buffer.height);
+    else
+        std::fprintf(out, "P6\n%d %d\n255\n", buffer.width, buffer.height);
+
+    size_t size = static_cast<size_t>(3) * buffer.width * buffer.height;
+    return std::fwrite(buffer.color, 1, size, out) == size;
+}
+
+// Only write to a rectangle from this thread
+void FrameBuffer::SetScissor(int x, int y, int w, int h)
+{
+    scissor.left   = x < 0 ? 0 : x;
+    scissor.top    = y < 0 ? 0 : y;
+    scissor.right  = x + w;
+    scissor.bottom = y + h;
+}
+
+// Write to the whole buffer from this thread
+void FrameBuffer::ResetScissor()
+{
+    scissor = {0, 0, INT_MAX, INT_MAX};
+}
+
+// Rectangle of the screen the calling thread can write to
+void FrameBuffer::GetClipRect(int & left, int & top, int & right, int & bottom)
+{
+    left   = scissor.left   > originX          ? scissor.left   : originX;
+    top    = scissor.top    > originY          ? scissor.top    : originY;
+    right  = scissor.right  < originX + width  ? scissor.right  : originX + width;
+    bottom = scissor.bottom < originY + height ? scissor.bottom : originY + height;
+}
+
+// Copy a rectangle of a buffer to a tile, which is then at that position of the screen.
+// The tile needs room for w*h pixels and only uses the overdraw if the source does
+void FrameBuffer::ReadTile(const Buffer & source, Buffer & tile, int x, int y, int w, int h)
+{
+    tile.x        = x;
+    tile.y        = y;
+    tile.width    = w;
+    tile.height   = h;
+    tile.counting = source.counting;
+
+    for (int row = 0; row < h; row++)
+    {
+        size_t from = static_cast<size_t>(y - source.y + row) * source.width + (x - source.x);
+        size_t to   = static_cast<size_t>(row) * w;
+
+        std::memcpy(tile.color + 3 * to, source.color + 3 * from, 3 * w);
+        std::memcpy(tile.depth + to, source.depth + from, w * sizeof(float));
+        if (tile.counting)
+            std::memcpy(tile.overdraw + to, source.overdraw + from, w);
     }
-}
\ No newline at end of file
+}
+
+// Copy a tile back to the rectangle of a buffer it was read from
+void FrameBuffer::WriteTile(const Buffer & tile, Buffer & target)
+{
+    for (int row = 0; row < tile.height; row++)
+    {
+        size_t from = static_cast<size_t>(row) * tile.width;
+        size_t to   = static_cast<size_t>(tile.y - target.y + row) * target.width + (tile.x - target.x);
+
+        std::memcpy(target.color + 3 * to, tile.color + 3 * from, 3 * tile.width);
+        std::memcpy(target.depth + to, tile.depth + from, tile.width * sizeof(float));
+        if (tile.counting)
+            std::memcpy(target.overdraw + to, tile.overdraw + from, tile.width);
+    }
+}
+
+// Start or stop counting the writes to every pixel of the bound buffer
+void FrameBuffer::EnableOverdraw(bool enable)
+{
+    if (enable && !overdraw && OverdrawBuffer)
+        std::memset(OverdrawBuffer, 0, width * height);
+
+    overdraw        = enable;
+    bound->counting = enable;
+}
+
+// Replace the colors with a heatmap of the writes to every pixel:
+// black for none, then blue, cyan, green, yellow, orange and red for 6 or more
+void FrameBuffer::ResolveOverdraw()
+{
+    static const unsigned char heat[7][3] =
+    {
+        {0, 0, 0}, {0, 0, 255}, {0, 255, 255}, {0, 255, 0}, {255, 255, 0}, {255, 128, 0}, {255, 0, 0}
+    };
+
+    if (!overdraw || imageData == nullptr)
+        return;
+
+    // The bands can run on any thread, which may have another buffer bound
+    unsigned char * colors = imageData;
+    unsigned char * counts = OverdrawBuffer;
+
+    ForEachBand(width * height, [colors, counts](int first, int last)
+    {
+        for (int i = first; i < last; i++)
+        {
+            int count = counts[i] < 6 ? counts[i] : 6;
+
+            colors[3 * i + 0] = heat[count][0];
+            colors[3 * i + 1] = heat[count][1];
+            colors[3 * i + 2] = heat[count][2];
+        }
+    });
+}
@@ -1,24 +1,131 @@
 #pragma once
-#include <SFML/Graphics.hpp>
+#include <cstdio>
+#include "Math/Point4.h"
+
+#ifndef CS250_HEADLESS
+namespace sf { class Image; }
+#endif
 
 class FrameBuffer
 {
   public:
-    static void Init(int w, int h);
+    // Memory of a render target, the functions below draw to the bound one
+    struct Buffer
+    {
+        int             width    = 0;
+        int             height   = 0;
+        unsigned char * color    = nullptr;
+        float         * depth    = nullptr;
+        unsigned char * overdraw = nullptr;   // writes per pixel, only counted when enabled
+        unsigned      * ids      = nullptr;   // visibility buffer, 0 except between drawing and ResolveIds
+        bool            counting = false;     // overdraw enabled while drawing to it
+        int             x        = 0;         // screen position of the top left pixel, only tiles
+        int             y        = 0;         // are not at the origin
+    };
+
+    static void Init(int w, int h);         // allocates and binds the default buffer
     static void Free();
 
+    static void     Allocate(Buffer & buffer, int w, int h);
+    static void     Release(Buffer & buffer);
+    static void     Bind(Buffer & buffer);    // for the calling thread only
+    static Buffer & GetBound() { return *bound; }
+
     static void Clear(unsigned char r = 0, unsigned char g = 0, unsigned char b = 0);
-    static void SetPixel(int x, int y, float z, unsigned char r, unsigned char g, unsigned char b);
+    static void Clear(int x, int y, int w, int h, unsigned char r, unsigned char g, unsigned char b);
+    static bool SetPixel(int x, int y, float z, unsigned char r, unsigned char g, unsigned char b);
     static void GetPixel(int x, int y, float& z, unsigned char & r, unsigned char & g, unsigned char & b);
+    static bool SetId(int x, int y, float z, unsigned id);      // depth test like SetPixel, id instead of the color
+    static bool SetDepth(int x, int y, float z);                // depth test like SetPixel, no color
+    static bool SetPixelIfEqual(int x, int y, float z, unsigned char r, unsigned char g, unsigned char b);  // only where the depth is z
     static int  GetWidth() { return width; }
     static int  GetHeight() { return height; }
 
+#ifndef CS250_HEADLESS
     static void ConvertFrameBufferToSFMLImage(sf::Image & image);
+    static void ConvertFrameBufferToSFMLImage(const Buffer & buffer, sf::Image & image);
+#endif
+    static void ConvertToRGBA(const Buffer & buffer, unsigned char * rgba);    // 4 bytes per pixel, as sf::Texture::update takes them
+    static unsigned char * AllocateRGBA(int w, int h);                          // target of ConvertToRGBA, on a cache line
+    static void            ReleaseRGBA(unsigned char * rgba);
+    static bool WritePPM(FILE * out);
+    static bool WritePPM(const Buffer & buffer, FILE * out, const char * comment = nullptr);
+
+    // Give the pixels of a rectangle of a buffer that have an id their color, shade(x, y, id)
+    // returns it as a Point4 from 0 to 1. The ids are set back to 0. Returns the pixels shaded
+    template <typename Shade>
+    static unsigned long long ResolveIds(Buffer & buffer, int x, int y, int w, int h, const Shade & shade);
+
+    // Copy a rectangle of a buffer to a tile that has room for it, and the tile back
+    static void ReadTile(const Buffer & source, Buffer & tile, int x, int y, int w, int h);
+    static void WriteTile(const Buffer & tile, Buffer & target);
+
+    static void EnableOverdraw(bool enable);
+    static void ResolveOverdraw();
+
+    // Rectangle SetPixel writes to on the calling thread, the whole buffer by default
+    static void SetScissor(int x, int y, int w, int h);
+    static void ResetScissor();
+
+    // Pixels SetPixel can write to: the bound buffer inside the scissor, the right and bottom are excluded
+    static void GetClipRect(int & left, int & top, int & right, int & bottom);
 
   private:
-    static int             width;
-    static int             height;
-    static unsigned char * imageData;
-    static float         * DepthBuffer;
+    static Buffer          default_buffer;  // buffer of Init
+
+    // Every thread draws to its own bound buffer, so several threads can render
+    // different frames at once. Jobs that draw for another thread bind its buffer
+    static thread_local Buffer *        bound;
+
+    // Copied from the bound buffer
+    static thread_local int             width;
+    static thread_local int             height;
+    static thread_local int             originX;
+    static thread_local int             originY;
+    static thread_local unsigned char * imageData;
+    static thread_local float         * DepthBuffer;
+    static thread_local unsigned char * OverdrawBuffer;   // writes per pixel, only counted when enabled
+    static thread_local bool            overdraw;
+
+    struct Scissor
+    {
+        int left, top, right, bottom;       // right and bottom are excluded
+    };
+    static thread_local Scissor scissor;
 
 };
+
+// Shade every pixel of the rectangle with an id, once
+template <typename Shade>
+unsigned long long FrameBuffer::ResolveIds(Buffer & buffer, int x, int y, int w, int h, const Shade & shade)
+{
+    int x0 = x > buffer.x ? x : buffer.x,   x1 = x + w < buffer.x + buffer.width  ? x + w : buffer.x + buffer.width;
+    int y0 = y > buffer.y ? y : buffer.y,   y1 = y + h < buffer.y + buffer.height ? y + h : buffer.y + buffer.height;
+
+    // The color writes could alias the buffer, so its pointers are kept apart
+    unsigned      * ids   = buffer.ids;
+    unsigned char * color = buffer.color;
+
+    unsigned long long shaded = 0;
+    for (int row = y0; row < y1; row++)
+    {
+        size_t pixel = static_cast<size_t>(row - buffer.y) * buffer.width + (x0 - buffer.x);
+
+        for (int col = x0; col < x1; col++, pixel++)
+        {
+            unsigned id = ids[pixel];
+            if (id == 0)
+                continue;
+
+            Point4 c = shade(col, row, id);
+            color[3 * pixel + 0] = static_cast<unsigned char>(c.r * 255.99);
+            color[3 * pixel + 1] = static_cast<unsigned char>(c.g * 255.99);
+            color[3 * pixel + 2] = static_cast<unsigned char>(c.b * 255.99);
+
+            ids[pixel] = 0;
+            shaded++;
+        }
+    }
+
+    return shaded;
+}
@@ -0,0 +1,150 @@
+/****************************************************************************************/
+/*!
+\file   FrameQueue.cpp
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+This file contains the implementation of the frame queue.
+Functions include:	FrameQueue, BeginProduce, EndProduce, BeginConsume, EndConsume,
+					Stop, Wait, Notify
+
+*/
+/****************************************************************************************/
+
+#include "FrameQueue.h"     //Header file
+#include <thread>           //yield
+
+namespace
+{
+    const int SPINS = 64;   //Checks before a side sleeps, a frame is usually much longer
+}
+
+/**
+* @brief FrameQueue:    queue with every slot free
+*
+* @param slots:         slots of the ring, at least 1
+*/
+FrameQueue::FrameQueue(int slots)
+    : slots(slots < 1 ? 1 : slots), produced(0), consumed(0), stopped(false), sleeping(0)
+{
+}
+
+/**
+* @brief Wait:      wait until the other side makes ready() true. The counter stores and the
+*                   sleeping count are sequentially consistent, so either this side sees the
+*                   new counter before it sleeps or the other side sees it sleeping
+*
+* @param ready:     condition to wait for, it must also be true once the queue is stopped
+*/
+template <typename Ready>
+void FrameQueue::Wait(const Ready & ready)
+{
+    for (int spin = 0; spin < SPINS; spin++)
+    {
+        if (ready())
+            return;
+
+        std::this_thread::yield();
+    }
+
+    std::unique_lock<std::mutex> guard(sleep_lock);
+    sleeping.fetch_add(1);
+    changed.wait(guard, ready);
+    sleeping.fetch_sub(1);
+}
+
+/**
+* @brief Notify:    wake the other side if it sleeps, after moving a counter
+*
+* @param (void)
+*/
+void FrameQueue::Notify()
+{
+    if (sleeping.load() > 0)
+    {
+        //Taking the lock makes sure the sleeper is either waiting already or checks again
+        {
+            std::lock_guard<std::mutex> guard(sleep_lock);
+        }
+        changed.notify_all();
+    }
+}
+
+/**
+* @brief BeginProduce:  wait until a slot is not waiting to be consumed
+*
+* @return               slot to fill, -1 if the queue is stopped
+*/
+int FrameQueue::BeginProduce()
+{
+    unsigned frame = produced.load(std::memory_order_relaxed);
+
+    //Every slot is queued or being consumed
+    Wait([this, frame]()
+    {
+        return frame - consumed.load() < static_cast<unsigned>(slots) || stopped.load();
+    });
+
+    if (stopped.load(std::memory_order_acquire))
+        return -1;
+
+    return static_cast<int>(frame % slots);
+}
+
+/**
+* @brief EndProduce:    hand the filled slot to the consumer
+*
+* @param (void)
+*/
+void FrameQueue::EndProduce()
+{
+    produced.store(produced.load(std::memory_order_relaxed) + 1);
+    Notify();
+}
+
+/**
+* @brief BeginConsume:  wait until a slot is filled
+*
+* @return               slot to use, -1 when there is nothing else to consume
+*/
+int FrameQueue::BeginConsume()
+{
+    unsigned frame = consumed.load(std::memory_order_relaxed);
+
+    Wait([this, frame]()
+    {
+        return frame != produced.load() || stopped.load();
+    });
+
+    //Check again after seeing the stop, the last slot may have been handed just before it
+    if (frame == produced.load(std::memory_order_acquire))
+        return -1;
+
+    return static_cast<int>(frame % slots);
+}
+
+/**
+* @brief EndConsume:    the consumed slot can be filled again
+*
+* @param (void)
+*/
+void FrameQueue::EndConsume()
+{
+    consumed.store(consumed.load(std::memory_order_relaxed) + 1);
+    Notify();
+}
+
+/**
+* @brief Stop:  let the consumer finish once it uses the slots already filled
+*
+* @param (void)
+*/
+void FrameQueue::Stop()
+{
+    stopped.store(true);
+    Notify();
+}
@@ -0,0 +1,63 @@
+/****************************************************************************************/
+/*!
+\file   FrameQueue.h
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+Order of the slots of a ring shared by one producer thread and one consumer
+thread, for frames that are made by one stage and used by the next. The slots
+are handed over with two atomic counters, each written by a single thread, so
+neither side takes a lock while the other one keeps up. A side that has to wait
+spins for a moment and then sleeps until the other side moves its counter.
+The owner of the queue keeps the data of the slots.
+Functions include:	FrameQueue, BeginProduce, EndProduce, BeginConsume, EndConsume,
+					Stop, Wait, Notify
+
+*/
+/****************************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+class FrameQueue
+{
+  public:
+    explicit FrameQueue(int slots);
+
+    // Producer: slot to fill next, waits while every slot is in use. -1 once stopped
+    int  BeginProduce();
+    void EndProduce();
+
+    // Consumer: oldest slot filled, waits for one. -1 once stopped and every slot is consumed
+    int  BeginConsume();
+    void EndConsume();
+
+    // Nothing else will be produced
+    void Stop();
+
+    int GetSlots() const { return slots; }
+
+  private:
+    // Wait until ready() is true, spinning first and then sleeping
+    template <typename Ready>
+    void Wait(const Ready & ready);
+
+    // Wake the side that sleeps, if any
+    void Notify();
+
+    int                     slots;
+    std::atomic<unsigned>   produced;     //Only the producer writes it
+    std::atomic<unsigned>   consumed;     //Only the consumer writes it
+    std::atomic<bool>       stopped;
+
+    std::atomic<int>        sleeping;     //Sides waiting on changed
+    std::mutex              sleep_lock;
+    std::condition_variable changed;
+};
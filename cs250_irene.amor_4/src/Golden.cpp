@@ -0,0 +1,438 @@
+/****************************************************************************************/
+/*!
+\file   Golden.cpp
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+This file contains the implementation of the golden-image regression check.
+Functions include:	Run, Cases, RenderCase, ReadPPM, WritePPM, Compare
+
+*/
+/****************************************************************************************/
+
+#include "Golden.h"             //Header file
+#include "AirplaneFunctions.h"  //Scene and renderer
+#include "Platform.h"           //fopen_s outside of MSVC
+#include <cstdio>
+#include <cstdlib>              //abs
+#include <string>
+#include <vector>
+
+namespace Golden
+{
+
+namespace
+{
+    //Every pose, camera and mode is rendered small to keep the references light, every
+    //triangle still covers some pixels. The longer spans and lines of the window size
+    //are checked on one pose in the solid and wireframe modes
+    const int SMALL_WIDTH  = 320;
+    const int SMALL_HEIGHT = 240;
+    const int FULL_WIDTH   = 1280;
+    const int FULL_HEIGHT  = 960;
+
+    //Key bit of a key
+    unsigned Key(Input::Key key) { return 1u << key; }
+
+    //Airplane poses, reached by replaying key states from the start of the scene
+    struct Pose
+    {
+        const char *            name;
+        std::vector<Input::Run> keys;
+    };
+
+    const Pose POSES[] =
+    {
+        {"start", {}},
+        {"maneuver",
+            {
+                {Key(Input::A) | Key(Input::Q) | Key(Input::Space), 12},   //Roll and yaw while flying
+                {Key(Input::S) | Key(Input::Space), 3},                    //Pitch down a little
+                {Key(Input::Space), 12},                                   //Fly straight
+                {Key(Input::X) | Key(Input::Y), 5},                        //Move the third person camera away
+            }
+        },
+        {"climb",
+            {
+                {Key(Input::W) | Key(Input::Space), 10},                   //Pitch up while flying
+                {Key(Input::D) | Key(Input::E) | Key(Input::Space), 10},   //Roll and yaw the other way
+                {Key(Input::Z) | Key(Input::H), 4},                        //Bring the third person camera closer
+            }
+        },
+        {"far",
+            {
+                {Key(Input::E) | Key(Input::Space), 30},                   //Turn away from the start
+                {Key(Input::X) | Key(Input::Y), 20},                       //Third person camera far and high
+            }
+        },
+    };
+
+    //Pose of the full size cases and of the renderer options
+    const Pose & FULL_POSE = POSES[1];
+
+    struct Named
+    {
+        const char * name;
+        int          value;
+    };
+
+    const Named CAMERAS[] =
+    {
+        {"first", Airplane::first}, {"rooted", Airplane::rooted}, {"third", Airplane::third}
+    };
+
+    const Named MODES[] =
+    {
+        {"depth", Airplane::depth_buffer}, {"wireframe", Airplane::wireframe},
+        {"solid", Airplane::solid}, {"overdraw", Airplane::overdraw}
+    };
+
+    const Named FULL_MODES[] =
+    {
+        {"wireframe", Airplane::wireframe}, {"solid", Airplane::solid}
+    };
+
+    //Renderer options of a case
+    struct Settings
+    {
+        int  layout;        //Views
+        int  tiles;         //Side of the tiles, 0 without tiles
+        int  shading;       //When the pixels get their colors
+        int  order;         //Order of the objects
+        bool occlusion;     //Skip the objects hidden behind the large ones
+        bool bvh;           //Skip the objects outside of the views with the hierarchy
+        bool lod;           //Simpler meshes far away, skip the objects smaller than a pixel
+        bool meshlets;      //Skip the clusters of faces outside of the views or turned away
+        bool static_batch;  //Only the camera for the objects that never move
+    };
+
+    const Settings DEFAULTS = {Airplane::single, 0, Airplane::forward, Airplane::file_order, false, false, false, false, false};
+
+    //Renderer options checked on every camera. The ones that must give the pixels of the
+    //default options are compared with its reference, the others have their own
+    struct Variant
+    {
+        const char * name;      //Added to the name of the case
+        unsigned     mode;      //Drawing mode
+        bool         full;      //Full size, small otherwise
+        bool         same;      //Same pixels as the default options
+        Settings     settings;
+    };
+
+    const Variant VARIANTS[] =
+    {
+        {"tiles16",      Airplane::solid,        true,  true,  {Airplane::single,             16, Airplane::forward,       Airplane::file_order,    false, false, false, false, false}},
+        {"tiles32",      Airplane::wireframe,    true,  true,  {Airplane::single,             32, Airplane::forward,       Airplane::file_order,    false, false, false, false, false}},
+        {"tiles64",      Airplane::depth_buffer, false, true,  {Airplane::single,             64, Airplane::forward,       Airplane::file_order,    false, false, false, false, false}},
+        {"tiles32",      Airplane::overdraw,     false, true,  {Airplane::single,             32, Airplane::forward,       Airplane::file_order,    false, false, false, false, false}},
+        {"prepass",      Airplane::solid,        true,  true,  {Airplane::single,             0,  Airplane::depth_prepass, Airplane::file_order,    false, false, false, false, false}},
+        {"prepass32",    Airplane::solid,        true,  true,  {Airplane::single,             32, Airplane::depth_prepass, Airplane::file_order,    false, false, false, false, false}},
+        {"visibility",   Airplane::solid,        true,  true,  {Airplane::single,             0,  Airplane::visibility,    Airplane::file_order,    false, false, false, false, false}},
+        {"visibility32", Airplane::solid,        true,  true,  {Airplane::single,             32, Airplane::visibility,    Airplane::file_order,    false, false, false, false, false}},
+        {"occlusion",    Airplane::solid,        true,  true,  {Airplane::single,             0,  Airplane::forward,       Airplane::file_order,    true,  false, false, false, false}},
+        {"bvh",          Airplane::solid,        true,  true,  {Airplane::single,             0,  Airplane::forward,       Airplane::file_order,    false, true,  false, false, false}},
+        {"bvh",          Airplane::wireframe,    true,  true,  {Airplane::single,             0,  Airplane::forward,       Airplane::file_order,    false, true,  false, false, false}},
+        {"meshlets",     Airplane::solid,        false, false, {Airplane::single,             0,  Airplane::forward,       Airplane::file_order,    false, false, false, true,  false}},
+        {"meshlets",     Airplane::wireframe,    true,  true,  {Airplane::single,             0,  Airplane::forward,       Airplane::file_order,    false, false, false, true,  false}},
+        {"front",        Airplane::solid,        false, false, {Airplane::single,             0,  Airplane::forward,       Airplane::front_to_back, false, false, false, false, false}},
+        {"lod",          Airplane::solid,        false, false, {Airplane::single,             0,  Airplane::forward,       Airplane::file_order,    false, false, true,  false, false}},
+        {"static",       Airplane::solid,        false, false, {Airplane::single,             0,  Airplane::forward,       Airplane::file_order,    false, false, false, false, true}},
+        {"split",        Airplane::solid,        false, false, {Airplane::split,              0,  Airplane::forward,       Airplane::file_order,    false, false, false, false, false}},
+        {"pip",          Airplane::wireframe,    false, false, {Airplane::picture_in_picture, 0,  Airplane::forward,       Airplane::file_order,    false, false, false, false, false}},
+    };
+
+    //A case to render and the reference it is compared with
+    struct Case
+    {
+        std::string  name;
+        std::string  reference;     //Name of the reference image, the one of another case if they must match
+        const Pose * pose;
+        int          camera;
+        unsigned     mode;
+        int          width, height;
+        Settings     settings;
+    };
+
+
+    /**
+    * @brief Cases:     every pose, camera and mode small, the full size ones and the renderer
+    *                   options on every camera
+    *
+    * @return           the cases, the ones a reference is made for before the ones that use it
+    */
+    std::vector<Case> Cases()
+    {
+        std::vector<Case> cases;
+
+        for (const Pose & pose : POSES)
+            for (const Named & camera : CAMERAS)
+                for (const Named & mode : MODES)
+                {
+                    std::string name = std::string(pose.name) + "_" + camera.name + "_" + mode.name;
+                    cases.push_back({name, name, &pose, camera.value, static_cast<unsigned>(mode.value),
+                                     SMALL_WIDTH, SMALL_HEIGHT, DEFAULTS});
+                }
+
+        for (const Named & camera : CAMERAS)
+            for (const Named & mode : FULL_MODES)
+            {
+                std::string name = std::string(FULL_POSE.name) + "_" + camera.name + "_" + mode.name + "_full";
+                cases.push_back({name, name, &FULL_POSE, camera.value, static_cast<unsigned>(mode.value),
+                                 FULL_WIDTH, FULL_HEIGHT, DEFAULTS});
+            }
+
+        for (const Variant & variant : VARIANTS)
+        {
+            const char * mode = "";
+            for (const Named & named : MODES)
+                if (static_cast<unsigned>(named.value) == variant.mode)
+                    mode = named.name;
+
+            for (const Named & camera : CAMERAS)
+            {
+                std::string base = std::string(FULL_POSE.name) + "_" + camera.name + "_" + mode + (variant.full ? "_full" : "");
+                std::string name = base + "_" + variant.name;
+                cases.push_back({name, variant.same ? base : name, &FULL_POSE, camera.value, variant.mode,
+                                 variant.full ? FULL_WIDTH : SMALL_WIDTH, variant.full ? FULL_HEIGHT : SMALL_HEIGHT,
+                                 variant.settings});
+            }
+        }
+
+        return cases;
+    }
+
+    /**
+    * @brief RenderCase:    render the last frame of the pose of a case with its camera, drawing
+    *                       mode and renderer options
+    *
+    * @param test:          case to render, the framebuffer must have its size
+    * @param pixels:        rendered colors, 3 bytes per pixel
+    */
+    void RenderCase(const Case & test, std::vector<unsigned char> & pixels)
+    {
+        const Settings & settings = test.settings;
+
+        Airplane airplane(test.width, test.height);
+        airplane.Airplane_Initialize();
+        airplane.SetCamera(test.camera);
+        airplane.SetDrawMode(test.mode);
+        airplane.SetLayout(settings.layout);
+        airplane.SetTileSize(settings.tiles);
+        airplane.SetShading(settings.shading);
+        airplane.SetDrawOrder(settings.order);
+        airplane.SetOcclusionCulling(settings.occlusion);
+        airplane.SetFrustumCulling(settings.bvh);
+        airplane.SetLevelOfDetail(settings.lod);
+        airplane.SetMeshletCulling(settings.meshlets);
+        airplane.SetStaticBatching(settings.static_batch);
+
+        //The poses come from the key states, never from the keyboard
+        Input::StartReplay(test.pose->keys);
+
+        //Every frame of the pose, then the one that is checked
+        unsigned frames = 1;
+        for (const Input::Run & run : test.pose->keys)
+            frames += run.count;
+
+        for (unsigned i = 0; i < frames; i++)
+        {
+            FrameBuffer::Clear(255, 255, 255);
+            airplane.Airplane_Update();
+        }
+
+        pixels.resize(3 * test.width * test.height);
+        for (int y = 0; y < test.height; y++)
+        {
+            for (int x = 0; x < test.width; x++)
+            {
+                float           z;
+                unsigned char * rgb = &pixels[3 * (y * test.width + x)];
+                FrameBuffer::GetPixel(x, y, z, rgb[0], rgb[1], rgb[2]);
+            }
+        }
+    }
+
+    /**
+    * @brief ReadPPM:   read a binary PPM image of a given size
+    *
+    * @param path:      file to read
+    * @param width:     width the image must have
+    * @param height:    height the image must have
+    * @param pixels:    colors of the image, 3 bytes per pixel
+    * @return           whether the image could be read
+    */
+    bool ReadPPM(const std::string & path, int width, int height, std::vector<unsigned char> & pixels)
+    {
+        FILE * in = nullptr;
+        fopen_s(&in, path.c_str(), "rb");
+        if (!in)
+            return false;
+
+        int  w = 0, h = 0, max = 0;
+        bool valid = fscanf_s(in, "P6 %d %d %d", &w, &h, &max) == 3 &&
+                     w == width && h == height && max == 255 && fgetc(in) != EOF;
+
+        if (valid)
+        {
+            pixels.resize(3 * width * height);
+            valid = fread(pixels.data(), 1, pixels.size(), in) == pixels.size();
+        }
+
+        fclose(in);
+        return valid;
+    }
+
+    /**
+    * @brief WritePPM:  write a binary PPM image
+    *
+    * @param path:      file to write
+    * @param width:     width of the image
+    * @param height:    height of the image
+    * @param pixels:    colors of the image, 3 bytes per pixel
+    * @return           whether the image could be written
+    */
+    bool WritePPM(const std::string & path, int width, int height, const std::vector<unsigned char> & pixels)
+    {
+        FILE * out = nullptr;
+        fopen_s(&out, path.c_str(), "wb");
+        if (!out)
+            return false;
+
+        fprintf(out, "P6\n%d %d\n255\n", width, height);
+        bool valid = fwrite(pixels.data(), 1, pixels.size(), out) == pixels.size();
+
+        fclose(out);
+        return valid;
+    }
+
+    /**
+    * @brief Compare:   compare a frame with its reference
+    *
+    * @param actual:    rendered colors
+    * @param expected:  reference colors
+    * @param tolerance: largest difference of a channel that still matches
+    * @param diff:      reference dimmed to gray with the pixels over the tolerance in red
+    * @param max_diff:  largest difference of a channel
+    * @return           number of pixels over the tolerance
+    */
+    int Compare(const std::vector<unsigned char> & actual, const std::vector<unsigned char> & expected,
+                int tolerance, std::vector<unsigned char> & diff, int & max_diff)
+    {
+        int bad  = 0;
+        max_diff = 0;
+        diff.resize(actual.size());
+
+        for (size_t i = 0; i < actual.size(); i += 3)
+        {
+            int pixel_diff = 0;
+            for (int c = 0; c < 3; c++)
+            {
+                int d = abs(actual[i + c] - expected[i + c]);
+                if (d > pixel_diff)
+                    pixel_diff = d;
+            }
+
+            if (pixel_diff > max_diff)
+                max_diff = pixel_diff;
+
+            if (pixel_diff > tolerance)
+            {
+                bad++;
+                diff[i]     = 255;
+                diff[i + 1] = 0;
+                diff[i + 2] = 0;
+            }
+            else
+            {
+                unsigned char gray = static_cast<unsigned char>(160 + (expected[i] + expected[i + 1] + expected[i + 2]) / 9);
+                diff[i] = diff[i + 1] = diff[i + 2] = gray;
+            }
+        }
+
+        return bad;
+    }
+}
+
+
+/**
+* @brief Run:       render every golden case and compare it with its reference
+*
+* @param options:   reference directory, tolerance and mode
+* @return           exit code of the program, 0 if every case matches
+*/
+int Run(const Options & options)
+{
+    std::string directory = options.directory;
+    std::string output    = options.output ? options.output : options.directory;
+
+    int cases = 0, failed = 0, written = 0;
+    std::vector<unsigned char> actual, expected, diff;
+
+    for (const Case & test : Cases())
+    {
+        const std::string & name = test.name;
+        std::string path = directory + "/" + test.reference + ".ppm";
+
+        FrameBuffer::Init(test.width, test.height);
+        RenderCase(test, actual);
+        FrameBuffer::Free();
+        cases++;
+
+        //Store the frame as the new reference, the cases that share the reference of
+        //another one are still compared with it
+        if (options.update && test.reference == name)
+        {
+            if (!WritePPM(path, test.width, test.height, actual))
+            {
+                printf("ERROR   %s: could not write %s\n", name.c_str(), path.c_str());
+                failed++;
+            }
+            else
+            {
+                printf("UPDATED %s\n", name.c_str());
+                written++;
+            }
+            continue;
+        }
+
+        if (!ReadPPM(path, test.width, test.height, expected))
+        {
+            printf("MISSING %s: no valid %dx%d reference %s\n", name.c_str(), test.width, test.height, path.c_str());
+            failed++;
+            continue;
+        }
+
+        int max_diff = 0;
+        int bad = Compare(actual, expected, options.tolerance, diff, max_diff);
+
+        if (bad <= options.max_bad)
+        {
+            printf("PASS    %s\n", name.c_str());
+            continue;
+        }
+
+        printf("FAIL    %s: %d pixels over the tolerance of %s, max channel difference %d\n",
+               name.c_str(), bad, test.reference.c_str(), max_diff);
+        failed++;
+
+        //Keep the frame and where it differs to look at them
+        WritePPM(output + "/" + name + "_actual.ppm", test.width, test.height, actual);
+        WritePPM(output + "/" + name + "_diff.ppm", test.width, test.height, diff);
+    }
+
+    Input::SetMode(Input::none);
+
+    if (options.update)
+        printf("%d references written to %s, %d of %d cases match\n", written, directory.c_str(), cases - failed, cases);
+    else
+        printf("%d of %d cases match\n", cases - failed, cases);
+
+    fflush(stdout);
+    return failed ? 1 : 0;
+}
+
+} // namespace Golden
@@ -0,0 +1,42 @@
+/****************************************************************************************/
+/*!
+\file   Golden.h
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+Golden-image regression check: renders a fixed set of camera poses in every
+drawing mode without a window and compares the frames against the reference
+images stored in a directory, so that changes to the Rasterizer and the
+FrameBuffer can be checked to not change the pixels. The renderer options are
+rendered too, the ones that must not change the pixels against the references
+of the default options.
+Functions include:	Run
+
+*/
+/****************************************************************************************/
+
+#pragma once
+
+namespace Golden
+{
+
+struct Options
+{
+    const char * directory = "golden";  //Reference images
+    const char * output    = nullptr;   //Where the diff images go, the reference directory if null
+    bool         update    = false;     //Write the references instead of comparing
+    int          tolerance = 1;         //Largest difference of a color channel that still matches
+    int          max_bad   = 0;         //Pixels per image allowed over the tolerance
+};
+
+// Renders every case and compares it with its reference image.
+// The result of every case is printed on stdout, and for the cases that fail
+// the rendered frame and an image of the differences are written next to the references.
+// Returns 0 if every case matches.
+int Run(const Options & options);
+
+} // namespace Golden
@@ -0,0 +1,157 @@
+/****************************************************************************************/
+/*!
+\file   Headless.cpp
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+This file contains the implementation of the offscreen renderer.
+Functions include:	Run
+
+*/
+/****************************************************************************************/
+
+#include "Headless.h"   //Header file
+#include "Pipeline.h"   //Simulation ahead of the renderer
+#include "Platform.h"   //fopen_s outside of MSVC
+#include <chrono>       //Frame timing
+#include <cstring>      //strcmp
+
+#ifdef _WIN32
+#include <io.h>         //_setmode
+#include <fcntl.h>      //_O_BINARY
+#endif
+
+namespace Headless
+{
+
+/**
+* @brief Run:       render the airplane scene without a window
+*
+* @param airplane:  initialized airplane scene
+* @param frames:    number of frames to render
+* @param output:    nullptr, "-" for stdout or the directory to write the frames to
+* @param pipelined: simulate each frame on another thread while the last one is rendered
+* @param frame_time:    simulated seconds between frames
+* @return           exit code of the program
+*/
+int Run(Airplane & airplane, int frames, const char * output, bool pipelined, double frame_time)
+{
+    using clock = std::chrono::high_resolution_clock;
+
+    bool to_stdout = output && !strcmp(output, "-");
+
+#ifdef _WIN32
+    //The frames are binary data
+    if (to_stdout)
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+    FrameBuffer::Init(airplane.WIDTH, airplane.HEIGHT);
+
+    //The frames are always the same time apart, however long they take to render
+    Pipeline pipeline(airplane, pipelined, frame_time);
+
+    double render_time = 0.0;       //Time spent only on rendering, in seconds
+    clock::time_point start = clock::now();
+
+    for (int frame = 0; frame < frames; frame++)
+    {
+        clock::time_point frame_start = clock::now();
+        PROFILE_BEGIN_FRAME();
+
+        {
+            PROFILE_SCOPE(clear);
+            FrameBuffer::Clear(255, 255, 255);
+        }
+        airplane.Render(*pipeline.BeginFrame());
+        pipeline.EndFrame();
+
+        PROFILE_END_FRAME();
+        render_time += std::chrono::duration<double>(clock::now() - frame_start).count();
+
+        //Write the frame
+        if (to_stdout)
+        {
+            FrameBuffer::WritePPM(stdout);
+        }
+        else if (output)
+        {
+            char path[1024];
+            std::snprintf(path, sizeof(path), "%s/frame_%05d.ppm", output, frame);
+
+            FILE * file = nullptr;
+            fopen_s(&file, path, "wb");
+            if (!file || !FrameBuffer::WritePPM(file))
+            {
+                std::fprintf(stderr, "Could not write %s\n", path);
+                if (file)
+                    std::fclose(file);
+                FrameBuffer::Free();
+                return 1;
+            }
+            std::fclose(file);
+        }
+    }
+
+    if (to_stdout)
+        std::fflush(stdout);
+
+    //The simulation thread has to be done with the input
+    pipeline.Stop();
+
+    Input::Finish();
+#ifdef CS250_PROFILE
+    Profiler::CloseCSV();
+    Trace::Stop();
+#endif
+
+    double total_time = std::chrono::duration<double>(clock::now() - start).count();
+
+    //Report on stderr so it does not get mixed with the frames on stdout
+    if (frames > 0)
+    {
+        std::fprintf(stderr, "%d frames at %dx%d\n", frames, airplane.WIDTH, airplane.HEIGHT);
+        std::fprintf(stderr, "render: %.3f s, %.2f fps, %.3f ms/frame\n",
+                     render_time, frames / render_time, 1000.0 * render_time / frames);
+        std::fprintf(stderr, "total:  %.3f s, %.2f fps, %.3f ms/frame\n",
+                     total_time, frames / total_time, 1000.0 * total_time / frames);
+
+        //Counters of the last frame
+        const Rasterizer::Stats & stats = Rasterizer::stats;
+        std::fprintf(stderr, "triangles: %llu submitted, %llu culled, %llu occluded, %llu simplified, %llu clipped, %llu rasterized\n",
+                     stats.triangles_submitted, stats.triangles_culled, stats.triangles_occluded,
+                     stats.triangles_simplified, stats.triangles_clipped, stats.triangles_rasterized);
+        std::fprintf(stderr, "pixels:    %llu tested, %llu passed depth, %llu line steps, %llu shaded, %llu in the prepass\n",
+                     stats.pixels_tested, stats.pixels_passed, stats.lines_stepped, stats.pixels_shaded, stats.prepass_tested);
+
+#ifdef CS250_PROFILE
+        std::fprintf(stderr, "memory:    %llu heap allocations\n", Profiler::GetFrameAllocations());
+
+        //Hardware counters of every stage over the last frames
+        if (PerfCounters::IsOpen())
+        {
+            std::fprintf(stderr, "%-14s %6s %8s %8s %8s\n", "stage", "ipc", "l1d/px", "llc/px", "br/px");
+            for (int i = 0; i < Profiler::StageCount; i++)
+            {
+                float ipc, l1d, llc, branch;
+                Profiler::GetCounterStats(static_cast<Profiler::Stage>(i), ipc, l1d, llc, branch);
+                std::fprintf(stderr, "%-14s %6.2f %8.4f %8.4f %8.4f\n",
+                             Profiler::GetName(static_cast<Profiler::Stage>(i)), ipc, l1d, llc, branch);
+            }
+        }
+#endif
+    }
+
+#ifdef CS250_PROFILE
+    PerfCounters::Close();
+#endif
+
+    FrameBuffer::Free();
+    return 0;
+}
+
+} // namespace Headless
@@ -0,0 +1,33 @@
+/****************************************************************************************/
+/*!
+\file   Headless.h
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+Offscreen renderer that drives the airplane scene for a fixed number of frames
+without opening a window, for batch rendering on machines without a display.
+Functions include:	Run
+
+*/
+/****************************************************************************************/
+
+#pragma once
+
+#include "AirplaneFunctions.h"
+
+namespace Headless
+{
+
+// Renders the given number of frames without a window.
+// output: nullptr to only render, "-" to stream PPM frames to stdout,
+// or a directory where frame_00000.ppm, frame_00001.ppm... are written.
+// pipelined: simulate the next frame on another thread while rendering.
+// frame_time: simulated seconds between frames, one step of the simulation by default.
+int Run(Airplane & airplane, int frames, const char * output, bool pipelined = true,
+        double frame_time = Airplane::TICK);
+
+} // namespace Headless
@@ -0,0 +1,253 @@
+/****************************************************************************************/
+/*!
+\file   Input.cpp
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+This file contains the implementation of the input recording and replay.
+Functions include:	SetMode, StartRecording, StartReplay, Finish, NextFrame,
+					IsKeyPressed, ReplayFinished
+
+*/
+/****************************************************************************************/
+
+#include "Input.h"              //Header file
+#include "Platform.h"           //fopen_s outside of MSVC
+#include <cstring>              //memcmp
+
+#ifndef CS250_HEADLESS
+#include <SFML/Window/Keyboard.hpp>
+#endif
+
+Input::Mode             Input::mode        = Input::live;
+unsigned                Input::state       = 0;
+unsigned                Input::frame       = 0;
+std::vector<Input::Run> Input::runs;
+size_t                  Input::run         = 0;
+unsigned                Input::run_frame   = 0;
+const char *            Input::record_file = nullptr;
+
+namespace
+{
+    //Header of the recording files
+    const char     MAGIC[8] = {'C', 'S', '2', '5', '0', 'I', 'N', 'P'};
+    const unsigned VERSION  = 1;
+
+#ifndef CS250_HEADLESS
+    //Keyboard key of each input key
+    const sf::Keyboard::Key KEYS[Input::KeyCount] =
+    {
+        sf::Keyboard::A, sf::Keyboard::D, sf::Keyboard::Q, sf::Keyboard::E,
+        sf::Keyboard::W, sf::Keyboard::S, sf::Keyboard::Space,
+        sf::Keyboard::Num0, sf::Keyboard::Num1, sf::Keyboard::Num2,
+        sf::Keyboard::Num3, sf::Keyboard::Num4, sf::Keyboard::Num5,
+        sf::Keyboard::Z, sf::Keyboard::X, sf::Keyboard::H, sf::Keyboard::Y,
+        sf::Keyboard::Num6, sf::Keyboard::Num7, sf::Keyboard::Num8, sf::Keyboard::Num9
+    };
+#endif
+}
+
+
+/**
+* @brief SetMode:   select where the key states come from
+*
+* @param m:         none or live (use StartRecording/StartReplay for the others)
+*/
+void Input::SetMode(Mode m)
+{
+    mode  = m;
+    state = 0;
+}
+
+/**
+* @brief StartRecording:    read the keyboard and save every frame to a file on Finish
+*
+* @param filename:          file to save the recording to
+* @return                   whether the recording started
+*/
+bool Input::StartRecording(const char * filename)
+{
+    if (!filename)
+        return false;
+
+    runs.clear();
+    record_file = filename;
+    mode        = record;
+    frame       = 0;
+
+    return true;
+}
+
+/**
+* @brief StartReplay:   read the key states from a recording
+*
+* @param filename:      recording to replay
+* @return               whether the recording could be read
+*/
+bool Input::StartReplay(const char * filename)
+{
+    FILE * in = nullptr;
+    fopen_s(&in, filename, "rb");
+    if (!in)
+    {
+        std::fprintf(stderr, "Could not open input recording %s\n", filename);
+        return false;
+    }
+
+    char     magic[8];
+    unsigned version = 0, count = 0;
+    bool     valid   = fread(magic, 1, 8, in) == 8 && !memcmp(magic, MAGIC, 8) &&
+                       fread(&version, sizeof(version), 1, in) == 1 && version == VERSION &&
+                       fread(&count, sizeof(count), 1, in) == 1;
+
+    if (valid)
+    {
+        runs.resize(count);
+        valid = count == 0 || fread(runs.data(), sizeof(Run), count, in) == count;
+    }
+    fclose(in);
+
+    if (!valid)
+    {
+        std::fprintf(stderr, "Invalid input recording %s\n", filename);
+        runs.clear();
+        return false;
+    }
+
+    StartReplay(runs);
+    return true;
+}
+
+/**
+* @brief StartReplay:   read the key states from a recording already in memory
+*
+* @param recording:     runs of key states to replay
+*/
+void Input::StartReplay(const std::vector<Run> & recording)
+{
+    if (&recording != &runs)
+        runs = recording;
+
+    mode      = replay;
+    state     = 0;
+    frame     = 0;
+    run       = 0;
+    run_frame = 0;
+}
+
+/**
+* @brief Finish:    write the recording to disk, if there is one
+*
+* @param (void)
+*/
+void Input::Finish()
+{
+    if (mode != record)
+        return;
+
+    mode = live;
+
+    FILE * out = nullptr;
+    fopen_s(&out, record_file, "wb");
+    if (!out)
+    {
+        std::fprintf(stderr, "Could not write input recording %s\n", record_file);
+        return;
+    }
+
+    unsigned count = static_cast<unsigned>(runs.size());
+    fwrite(MAGIC, 1, 8, out);
+    fwrite(&VERSION, sizeof(VERSION), 1, out);
+    fwrite(&count, sizeof(count), 1, out);
+    if (count)
+        fwrite(runs.data(), sizeof(Run), count, out);
+    fclose(out);
+}
+
+/**
+* @brief NextFrame: get the key state of the next frame
+*
+* @param (void)
+*/
+void Input::NextFrame()
+{
+    switch (mode)
+    {
+    case none:
+        state = 0;
+        break;
+
+    case live:
+    case record:
+        state = 0;
+#ifndef CS250_HEADLESS
+        for (int key = 0; key < KeyCount; key++)
+        {
+            if (sf::Keyboard::isKeyPressed(KEYS[key]))
+                state |= 1u << key;
+        }
+#endif
+
+        //Extend the last run while the keys don't change
+        if (mode == record)
+        {
+            if (!runs.empty() && runs.back().keys == state)
+                runs.back().count++;
+            else
+                runs.push_back({state, 1});
+        }
+        break;
+
+    case replay:
+        //Skip the runs already consumed
+        while (run < runs.size() && run_frame >= runs[run].count)
+        {
+            run++;
+            run_frame = 0;
+        }
+
+        //Nothing is pressed once the recording is over
+        if (run < runs.size())
+        {
+            state = runs[run].keys;
+            run_frame++;
+        }
+        else
+            state = 0;
+        break;
+    }
+
+    frame++;
+}
+
+/**
+* @brief IsKeyPressed:  whether the key is pressed in the current frame
+*
+* @param key:           key to check
+* @return               true if pressed
+*/
+bool Input::IsKeyPressed(Key key)
+{
+    return (state & (1u << key)) != 0;
+}
+
+/**
+* @brief ReplayFinished:    whether every frame of the recording has been read
+*
+* @return                   true once the replay is over, false if not replaying
+*/
+bool Input::ReplayFinished()
+{
+    if (mode != replay)
+        return false;
+
+    size_t next = run;
+    if (next < runs.size() && run_frame >= runs[next].count)
+        next++;
+
+    return next >= runs.size();
+}
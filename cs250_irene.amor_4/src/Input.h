@@ -0,0 +1,72 @@
+/****************************************************************************************/
+/*!
+\file   Input.h
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+Key state of every simulation step of the airplane. The keys can come from the
+keyboard, be recorded to a file while playing, or be replayed from a recording
+so that two runs render exactly the same frame sequence.
+Functions include:	SetMode, StartRecording, StartReplay, Finish, NextFrame,
+					IsKeyPressed, ReplayFinished, GetFrame
+
+*/
+/****************************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+class Input
+{
+  public:
+    //Keys used by the airplane, one bit each in the key state
+    enum Key
+    {
+        A, D, Q, E, W, S, Space,
+        Num0, Num1, Num2, Num3, Num4, Num5,
+        Z, X, H, Y,
+        Num6, Num7, Num8, Num9,
+        KeyCount
+    };
+
+    enum Mode
+    {
+        none,       //No key is ever pressed (no window)
+        live,       //Read the keyboard
+        record,     //Read the keyboard and save the key states
+        replay      //Read the key states from a recording
+    };
+
+    //Run of consecutive frames with the same key state
+    struct Run
+    {
+        unsigned keys;
+        unsigned count;
+    };
+
+    static void SetMode(Mode m);
+    static bool StartRecording(const char * filename);
+    static bool StartReplay(const char * filename);
+    static void StartReplay(const std::vector<Run> & recording);
+    static void Finish();
+
+    static void     NextFrame();
+    static bool     IsKeyPressed(Key key);
+    static bool     ReplayFinished();
+    static unsigned GetFrame() { return frame; }
+
+  private:
+    static Mode             mode;
+    static unsigned         state;      //Bit per key of the current frame
+    static unsigned         frame;      //Frames read so far
+    static std::vector<Run> runs;       //Recording, run-length encoded
+    static size_t           run;        //Replay position
+    static unsigned         run_frame;
+    static const char *     record_file;
+};
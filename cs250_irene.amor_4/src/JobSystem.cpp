@@ -0,0 +1,393 @@
+/****************************************************************************************/
+/*!
+\file   JobSystem.cpp
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+This file contains the implementation of the job system.
+Functions include:	Init, Shutdown, GetThreadCount, Run, ParallelFor, Wait, Push,
+					RunOne, Execute, WorkerLoop
+
+*/
+/****************************************************************************************/
+
+#include "JobSystem.h"      //Header file
+#include "Trace.h"          //Jobs in the trace
+#include <condition_variable>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>        //SetThreadAffinityMask
+#elif defined(__linux__)
+#include <pthread.h>        //pthread_setaffinity_np
+#endif
+
+namespace
+{
+    const unsigned QUEUE_JOBS        = 1024;    //Jobs of a queue, more run right away
+    const int      PIECES_PER_THREAD = 4;       //Most pieces of a ParallelFor per thread
+    const int      SPINS             = 64;      //Tries to find a job before a worker sleeps
+
+    //Jobs of one thread. The owner takes the newest one, the others steal the oldest one
+    struct Queue
+    {
+        std::mutex     lock;
+        JobSystem::Job jobs[QUEUE_JOBS];
+        unsigned       head = 0;        //Oldest job
+        unsigned       tail = 0;        //One past the newest job
+    };
+
+    //Queue 0 is shared by the threads that are not workers
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread>            workers;
+    int                                 thread_count = 1;
+    thread_local int                    thread_index = 0;
+
+    //The workers sleep while every queue is empty
+    std::atomic<bool>       running(false);
+    std::atomic<int>        queued(0);
+    std::atomic<int>        sleeping(0);
+    std::mutex              sleep_lock;
+    std::condition_variable wake;
+
+
+    /**
+    * @brief Take:      take a job out of a queue
+    *
+    * @param queue:     queue to take it from
+    * @param newest:    take the newest job instead of the oldest one
+    * @param job:       job taken
+    * @return           false if the queue is empty
+    */
+    bool Take(Queue & queue, bool newest, JobSystem::Job & job)
+    {
+        std::lock_guard<std::mutex> guard(queue.lock);
+
+        if (queue.head == queue.tail)
+            return false;
+
+        if (newest)
+            job = queue.jobs[--queue.tail % QUEUE_JOBS];
+        else
+            job = queue.jobs[queue.head++ % QUEUE_JOBS];
+
+        return true;
+    }
+
+    /**
+    * @brief Pin:       keep a thread on one core
+    *
+    * @param thread:    thread to pin
+    * @param core:      index of the core
+    */
+    void Pin(std::thread & thread, int core)
+    {
+#ifdef _WIN32
+        SetThreadAffinityMask(thread.native_handle(), static_cast<DWORD_PTR>(1) << core);
+#elif defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(core, &set);
+        pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#else
+        (void)thread;
+        (void)core;
+#endif
+    }
+}
+
+
+/**
+* @brief Init:      start the worker threads, the caller is one of the threads
+*
+* @param threads:   threads that run jobs, 0 for one per core
+* @param pin:       keep worker i on core i, the caller stays on any core
+*/
+void JobSystem::Init(int threads, bool pin)
+{
+    Shutdown();
+
+    int cores = static_cast<int>(std::thread::hardware_concurrency());
+    if (cores < 1)
+        cores = 1;
+    if (threads <= 0)
+        threads = cores;
+
+    thread_count = threads;
+    thread_index = 0;
+    if (threads == 1)
+        return;
+
+    for (int i = 0; i < threads; i++)
+        queues.emplace_back(new Queue);
+
+    running.store(true);
+    for (int i = 1; i < threads; i++)
+    {
+        workers.emplace_back(&JobSystem::WorkerLoop, i);
+        if (pin)
+            Pin(workers.back(), i % cores);
+    }
+}
+
+/**
+* @brief Shutdown:  stop the worker threads, no job can be left
+*
+* @param (void)
+*/
+void JobSystem::Shutdown()
+{
+    if (!workers.empty())
+    {
+        {
+            std::lock_guard<std::mutex> guard(sleep_lock);
+            running.store(false);
+        }
+        wake.notify_all();
+
+        for (std::thread & worker : workers)
+            worker.join();
+        workers.clear();
+    }
+
+    queues.clear();
+    queued.store(0);
+    thread_count = 1;
+}
+
+/**
+* @brief GetThreadCount:    threads that run jobs, including the callers
+*
+* @return                   1 if every job runs on the calling thread
+*/
+int JobSystem::GetThreadCount()
+{
+    return thread_count;
+}
+
+/**
+* @brief Run:       run a function over a range, on any thread
+*
+* @param function:  work of the job
+* @param data:      passed to the function, has to live until the job is done
+* @param begin:     first index
+* @param end:       one past the last index
+* @param counter:   group the job counts towards, can be nullptr
+* @param after:     group that has to be done before the job starts, can be nullptr
+*/
+void JobSystem::Run(Function function, void * data, int begin, int end, Counter * counter, Counter * after)
+{
+    Job job = {function, data, begin, end, counter};
+
+    if (counter)
+        counter->pending.fetch_add(1, std::memory_order_relaxed);
+
+    //Wait for the group, the last of its jobs starts this one
+    if (after)
+    {
+        std::unique_lock<std::mutex> guard(after->lock);
+        if (!after->IsDone())
+        {
+            if (after->waiting_count < Counter::MAX_WAITING)
+            {
+                after->waiting[after->waiting_count++] = job;
+                return;
+            }
+
+            //No room to wait, help the group finish instead
+            guard.unlock();
+            Wait(*after);
+        }
+    }
+
+    if (thread_count == 1)
+        Execute(job);
+    else
+        Push(job);
+}
+
+/**
+* @brief ParallelFor:   split a range into jobs
+*
+* @param begin:         first index
+* @param end:           one past the last index
+* @param grain:         most indices of a job, there are at most a few jobs per thread
+* @param function:      work of the jobs
+* @param data:          passed to the function, has to live until the jobs are done
+* @param counter:       group the jobs count towards, can be nullptr
+* @param after:         group that has to be done before the jobs start, can be nullptr
+*/
+void JobSystem::ParallelFor(int begin, int end, int grain, Function function, void * data,
+                            Counter * counter, Counter * after)
+{
+    if (begin >= end)
+        return;
+
+    if (grain < 1)
+        grain = 1;
+
+    //Larger pieces than the grain if there would be too many of them
+    int count  = end - begin;
+    int pieces = (count + grain - 1) / grain;
+    if (pieces > thread_count * PIECES_PER_THREAD)
+        pieces = thread_count * PIECES_PER_THREAD;
+
+    int size = (count + pieces - 1) / pieces;
+    for (int first = begin; first < end; first += size)
+        Run(function, data, first, first + size < end ? first + size : end, counter, after);
+}
+
+/**
+* @brief Wait:      run jobs until every job of the group is done
+*
+* @param counter:   group to wait for
+*/
+void JobSystem::Wait(Counter & counter)
+{
+    while (!counter.IsDone())
+    {
+        if (!RunOne())
+            std::this_thread::yield();
+    }
+
+    //The last job may not have let go of the group yet
+    std::lock_guard<std::mutex> guard(counter.lock);
+}
+
+/**
+* @brief Push:  add a job to the queue of the calling thread and wake a worker
+*
+* @param job:   job to add
+*/
+void JobSystem::Push(const Job & job)
+{
+    Queue & queue = *queues[thread_index];
+    bool    added = false;
+
+    {
+        std::lock_guard<std::mutex> guard(queue.lock);
+
+        if (queue.tail - queue.head < QUEUE_JOBS)
+        {
+            queue.jobs[queue.tail++ % QUEUE_JOBS] = job;
+            added = true;
+        }
+    }
+
+    //The queue is full
+    if (!added)
+    {
+        Execute(job);
+        return;
+    }
+
+    queued.fetch_add(1);
+    if (sleeping.load() > 0)
+    {
+        std::lock_guard<std::mutex> guard(sleep_lock);
+        wake.notify_one();
+    }
+}
+
+/**
+* @brief RunOne:    run the newest job of this thread, or steal the oldest job of another one
+*
+* @return           false if there was no job
+*/
+bool JobSystem::RunOne()
+{
+    if (queues.empty())
+        return false;
+
+    Job  job;
+    bool found = Take(*queues[thread_index], true, job);
+
+    for (int i = 1; !found && i < thread_count; i++)
+        found = Take(*queues[(thread_index + i) % thread_count], false, job);
+
+    if (!found)
+        return false;
+
+    queued.fetch_sub(1);
+    Execute(job);
+    return true;
+}
+
+/**
+* @brief Execute:   run a job and start the jobs waiting for its group
+*
+* @param job:       job to run
+*/
+void JobSystem::Execute(const Job & job)
+{
+    {
+        TRACE_SCOPE("job");
+        job.function(job.data, job.begin, job.end);
+    }
+
+    Counter * counter = job.counter;
+    if (!counter)
+        return;
+
+    //Take the waiting jobs out, the group can be gone once the lock is released
+    Job ready[Counter::MAX_WAITING];
+    int ready_count = 0;
+    {
+        std::lock_guard<std::mutex> guard(counter->lock);
+        if (counter->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            for (ready_count = 0; ready_count < counter->waiting_count; ready_count++)
+                ready[ready_count] = counter->waiting[ready_count];
+            counter->waiting_count = 0;
+        }
+    }
+
+    for (int i = 0; i < ready_count; i++)
+    {
+        if (thread_count == 1)
+            Execute(ready[i]);
+        else
+            Push(ready[i]);
+    }
+}
+
+/**
+* @brief WorkerLoop:    run jobs until Shutdown, sleeping while there are none
+*
+* @param index:         queue of the worker
+*/
+void JobSystem::WorkerLoop(int index)
+{
+    thread_index = index;
+    TRACE_THREAD_NAME("worker");
+
+    int idle = 0;
+    while (running.load(std::memory_order_acquire))
+    {
+        if (RunOne())
+        {
+            idle = 0;
+            continue;
+        }
+
+        if (++idle < SPINS)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> guard(sleep_lock);
+        sleeping.fetch_add(1);
+        wake.wait(guard, []() { return queued.load() > 0 || !running.load(); });
+        sleeping.fetch_sub(1);
+        idle = 0;
+    }
+}
@@ -0,0 +1,144 @@
+/****************************************************************************************/
+/*!
+\file   JobSystem.h
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+Pool of worker threads shared by every stage of the renderer. Each thread has
+its own queue of jobs: it takes the newest job of its queue, and when the queue
+is empty it steals the oldest job of another thread. A job runs a function over
+a range of indices and can count towards a Counter, which other jobs can wait
+for before they start.
+
+Without Init, or with a single thread, every job runs on the calling thread.
+Functions include:	Init, Shutdown, GetThreadCount, Run, ParallelFor, Wait
+
+*/
+/****************************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+class JobSystem
+{
+  public:
+    // Work of a job over the indices [begin, end)
+    typedef void (*Function)(void * data, int begin, int end);
+
+    class Counter;
+
+    struct Job
+    {
+        Function  function;
+        void *    data;
+        int       begin;
+        int       end;
+        Counter * counter;          // finished jobs are counted here, can be nullptr
+    };
+
+    // Jobs of a group that are not finished yet, and the jobs waiting for them
+    class Counter
+    {
+      public:
+        Counter() : pending(0), waiting_count(0) {}
+
+        bool IsDone() const { return pending.load(std::memory_order_acquire) == 0; }
+
+      private:
+        friend class JobSystem;
+
+        static const int MAX_WAITING = 64;
+
+        std::atomic<int> pending;
+        std::mutex       lock;
+        Job              waiting[MAX_WAITING];     // started when the group is done
+        int              waiting_count;
+    };
+
+    // threads: threads that run jobs, including the caller. 0 for one per core
+    // pin:     keep every worker on its own core
+    static void Init(int threads = 0, bool pin = false);
+    static void Shutdown();
+    static int  GetThreadCount();
+
+    // Run the function over [begin, end) once the after group is done
+    static void Run(Function function, void * data, int begin, int end,
+                    Counter * counter = nullptr, Counter * after = nullptr);
+
+    // Split [begin, end) into jobs of at most grain indices
+    static void ParallelFor(int begin, int end, int grain, Function function, void * data,
+                            Counter * counter, Counter * after = nullptr);
+
+    // Run body(begin, end) over pieces of [begin, end) and wait for all of them
+    template <typename Body>
+    static void ParallelFor(int begin, int end, int grain, const Body & body);
+
+    // Same without waiting, the body has to live until the counter is done
+    template <typename Body>
+    static void ParallelFor(int begin, int end, int grain, const Body & body,
+                            Counter & counter, Counter * after = nullptr);
+
+    // Run other jobs until every job of the group is done
+    static void Wait(Counter & counter);
+
+  private:
+    template <typename Body>
+    static void Call(void * data, int begin, int end)
+    {
+        (*static_cast<const Body *>(data))(begin, end);
+    }
+
+    static void Push(const Job & job);
+    static bool RunOne();
+    static void Execute(const Job & job);
+    static void WorkerLoop(int index);
+};
+
+/**
+* @brief ParallelFor:   run the body over pieces of a range and wait for all of them
+*
+* @param begin:         first index
+* @param end:           one past the last index
+* @param grain:         most indices of a piece
+* @param body:          callable as body(int begin, int end)
+*/
+template <typename Body>
+void JobSystem::ParallelFor(int begin, int end, int grain, const Body & body)
+{
+    if (begin >= end)
+        return;
+
+    //Not worth splitting
+    if (GetThreadCount() == 1 || end - begin <= grain)
+    {
+        body(begin, end);
+        return;
+    }
+
+    Counter counter;
+    ParallelFor(begin, end, grain, &Call<Body>, const_cast<Body *>(&body), &counter);
+    Wait(counter);
+}
+
+/**
+* @brief ParallelFor:   run the body over pieces of a range once another group is done
+*
+* @param begin:         first index
+* @param end:           one past the last index
+* @param grain:         most indices of a piece
+* @param body:          callable as body(int begin, int end), lives until the counter is done
+* @param counter:       group the pieces count towards
+* @param after:         group that has to be done before the pieces start, can be nullptr
+*/
+template <typename Body>
+void JobSystem::ParallelFor(int begin, int end, int grain, const Body & body,
+                            Counter & counter, Counter * after)
+{
+    ParallelFor(begin, end, grain, &Call<Body>, const_cast<Body *>(&body), &counter, after);
+}
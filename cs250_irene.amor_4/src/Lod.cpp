@@ -0,0 +1,208 @@
+/****************************************************************************************/
+/*!
+\file   Lod.cpp
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+This file contains the implementation of the levels of detail.
+Functions include:	Build, Select, Simplify
+
+*/
+/****************************************************************************************/
+
+#include "Lod.h"        //Header file
+#include <algorithm>    //min, max, rotate
+#include <cmath>        //sqrt
+#include <unordered_set> //Faces already added
+
+namespace Lod
+{
+
+namespace
+{
+    /**
+    * @brief Simplify:      snap the vertices of a mesh to a grid and keep the faces
+    *                       whose corners are still in different cells
+    *
+    * @param full:          full mesh
+    * @param resolution:    cells along each side of the grid
+    * @param simple:        simpler mesh
+    */
+    void Simplify(const Mesh & full, int resolution, Mesh & simple)
+    {
+        const int vertices = static_cast<int>(full.vertices.size());
+
+        //Grid over the box of the mesh, flat sides get one cell
+        float low[3], size[3];
+        for (int axis = 0; axis < 3; axis++)
+        {
+            float high = low[axis] = full.vertices[0].v[axis];
+            for (const Point4 & vertex : full.vertices)
+            {
+                low[axis] = std::min(low[axis], vertex.v[axis]);
+                high      = std::max(high, vertex.v[axis]);
+            }
+            size[axis] = high > low[axis] ? (high - low[axis]) / resolution : 1.f;
+        }
+
+        //Cluster of every vertex, in the order their cells are first found
+        std::vector<int>    cluster_of_cell(resolution * resolution * resolution, -1);
+        std::vector<int>    cluster_of(vertices);
+        std::vector<Point4> sums;
+        std::vector<int>    counts;
+        for (int v = 0; v < vertices; v++)
+        {
+            int cell[3];
+            for (int axis = 0; axis < 3; axis++)
+                cell[axis] = std::min(static_cast<int>((full.vertices[v].v[axis] - low[axis]) / size[axis]), resolution - 1);
+
+            int & cluster = cluster_of_cell[(cell[2] * resolution + cell[1]) * resolution + cell[0]];
+            if (cluster < 0)
+            {
+                cluster = static_cast<int>(sums.size());
+                sums.push_back(Point4(0.f, 0.f, 0.f, 0.f));
+                counts.push_back(0);
+            }
+
+            cluster_of[v] = cluster;
+            for (int axis = 0; axis < 3; axis++)
+                sums[cluster].v[axis] += full.vertices[v].v[axis];
+            counts[cluster]++;
+        }
+
+        //The faces with their corners in three clusters, each one once with its winding
+        const long long clusters = static_cast<long long>(sums.size());
+        std::unordered_set<long long> added;
+        std::vector<int> vertex_of(sums.size(), -1);
+        simple = Mesh();
+
+        for (size_t f = 0; f < full.faces.size(); f++)
+        {
+            int corners[3];
+            for (int j = 0; j < 3; j++)
+                corners[j] = cluster_of[full.faces[f].indices[j]];
+
+            if (corners[0] == corners[1] || corners[1] == corners[2] || corners[2] == corners[0])
+                continue;
+
+            //The same face from any of its corners
+            std::rotate(corners, std::min_element(corners, corners + 3), corners + 3);
+            if (!added.insert((corners[0] * clusters + corners[1]) * clusters + corners[2]).second)
+                continue;
+
+            CS250Parser::Face face;
+            for (int j = 0; j < 3; j++)
+            {
+                //Only the clusters of some face become vertices
+                int & vertex = vertex_of[corners[j]];
+                if (vertex < 0)
+                {
+                    const Point4 & sum = sums[corners[j]];
+                    float count = static_cast<float>(counts[corners[j]]);
+                    vertex = static_cast<int>(simple.vertices.size());
+                    simple.vertices.push_back(Point4(sum.x / count, sum.y / count, sum.z / count));
+                }
+                face.indices[j] = vertex;
+            }
+
+            simple.faces.push_back(face);
+            simple.colors.push_back(full.colors[f]);
+        }
+
+        //How far the vertices moved
+        for (int v = 0; v < vertices; v++)
+        {
+            int vertex = vertex_of[cluster_of[v]];
+            if (vertex < 0)
+                continue;
+
+            float dx = simple.vertices[vertex].x - full.vertices[v].x;
+            float dy = simple.vertices[vertex].y - full.vertices[v].y;
+            float dz = simple.vertices[vertex].z - full.vertices[v].z;
+            simple.error = std::max(simple.error, std::sqrt(dx * dx + dy * dy + dz * dz));
+        }
+    }
+}
+
+
+/**
+* @brief Build:     make the levels of a mesh, the full mesh and the grids of MAX_RESOLUTION
+*                   cells and half as many every level, the ones that drop some faces but
+*                   not all of them
+*
+* @param chain:     levels of the mesh, anything in it is replaced
+* @param vertices:  vertices of the full mesh
+* @param faces:     faces of the full mesh
+*/
+void Build(Chain & chain, const std::vector<Point4> & vertices, const std::vector<CS250Parser::Face> & faces)
+{
+    chain.levels.clear();
+    chain.levels.emplace_back();
+
+    Mesh & full = chain.levels.back();
+    full.vertices = vertices;
+    full.faces    = faces;
+    for (int f = 0; f < static_cast<int>(faces.size()); f++)
+        full.colors.push_back(f);
+
+    //Sphere around the box of the mesh
+    chain.center = Point4(0.f, 0.f, 0.f);
+    chain.radius = 0.f;
+    if (vertices.empty())
+    {
+        Meshlet::Build(full.meshlets, vertices, faces);
+        return;
+    }
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+        float low = vertices[0].v[axis], high = vertices[0].v[axis];
+        for (const Point4 & vertex : vertices)
+        {
+            low  = std::min(low, vertex.v[axis]);
+            high = std::max(high, vertex.v[axis]);
+        }
+        chain.center.v[axis] = 0.5f * (low + high);
+    }
+    for (const Point4 & vertex : vertices)
+    {
+        float dx = vertex.x - chain.center.x, dy = vertex.y - chain.center.y, dz = vertex.z - chain.center.z;
+        chain.radius = std::max(chain.radius, std::sqrt(dx * dx + dy * dy + dz * dz));
+    }
+
+    for (int resolution = MAX_RESOLUTION; resolution >= 1 && static_cast<int>(chain.levels.size()) < MAX_LEVELS; resolution /= 2)
+    {
+        //Always from the full mesh, so the error is the one against it
+        Mesh simple;
+        Simplify(chain.levels[0], resolution, simple);
+
+        if (!simple.faces.empty() && simple.faces.size() < chain.levels.back().faces.size())
+            chain.levels.push_back(simple);
+    }
+
+    for (Mesh & level : chain.levels)
+        Meshlet::Build(level.meshlets, level.vertices, level.faces);
+}
+
+/**
+* @brief Select:            simplest level whose vertices moved at most some pixels
+*
+* @param chain:             levels of the mesh
+* @param pixels_per_unit:   screen pixels of a model unit at the distance of the object
+* @param max_error:         pixels a vertex can move
+* @return                   level to draw
+*/
+int Select(const Chain & chain, float pixels_per_unit, float max_error)
+{
+    int level = 0;
+    while (level + 1 < static_cast<int>(chain.levels.size()) && chain.levels[level + 1].error * pixels_per_unit <= max_error)
+        level++;
+
+    return level;
+}
+
+} // namespace Lod
@@ -0,0 +1,58 @@
+/****************************************************************************************/
+/*!
+\file   Lod.h
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+Levels of detail of the mesh of the objects. The simpler levels are made when
+the scene is loaded by vertex clustering: the vertices are snapped to a grid
+over the mesh, every cell becomes one vertex at the average of its vertices,
+and the faces that lose a corner are dropped. Every level keeps how far its
+vertices moved, so the renderer can take the simplest one whose error is less
+than a pixel at the distance of the object. Every level is split into its own
+clusters of faces.
+Functions include:	Build, Select
+
+*/
+/****************************************************************************************/
+
+#pragma once
+
+#include "CS250Parser.h"
+#include "Meshlet.h"
+#include "Math/Point4.h"
+#include <vector>
+
+namespace Lod
+{
+
+const int MAX_LEVELS     = 4;   // levels of a chain, the full mesh included
+const int MAX_RESOLUTION = 16;  // cells along each side of the grid of the first simpler level
+
+struct Mesh
+{
+    std::vector<Point4>            vertices;
+    std::vector<CS250Parser::Face> faces;
+    std::vector<int>               colors;      // face of the full mesh each face takes its color from
+    float                          error = 0.f; // farthest a vertex moved from the full mesh
+    Meshlet::Set                   meshlets;    // clusters of the faces
+};
+
+struct Chain
+{
+    std::vector<Mesh> levels;       // the full mesh first, then fewer faces every level
+    Point4            center;       // sphere around the full mesh
+    float             radius = 0.f;
+};
+
+// Make the levels of a mesh
+void Build(Chain & chain, const std::vector<Point4> & vertices, const std::vector<CS250Parser::Face> & faces);
+
+// Simplest level whose error is at most max_error pixels, at a number of pixels per model unit
+int Select(const Chain & chain, float pixels_per_unit, float max_error);
+
+} // namespace Lod
@@ -23,6 +23,7 @@ Hours spent on this assignment: ~10
 
 #include "Vector4.h"		//Header file
 #include "MathUtilities.h"	//Helper macros
+#include <cmath>			//sqrt
 
 
 /**
@@ -0,0 +1,270 @@
+/****************************************************************************************/
+/*!
+\file   Meshlet.cpp
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+This file contains the implementation of the clusters of faces.
+Functions include:	Build, Outside, FacesAway, Grow, FitBounds
+
+*/
+/****************************************************************************************/
+
+#include "Meshlet.h"    //Header file
+#include <algorithm>    //min, max
+#include <cmath>        //sqrt
+
+namespace Meshlet
+{
+
+namespace
+{
+    //Faces around every vertex, the ones of vertex v from start[v] to start[v + 1]
+    struct Adjacency
+    {
+        std::vector<int> start;
+        std::vector<int> faces;
+    };
+
+    /**
+    * @brief Grow:          add a cluster from a face to the faces around it, breadth first,
+    *                       skipping the ones that turn away from it or add too many vertices
+    *
+    * @param set:           set the cluster is added to
+    * @param seed:          first face of the cluster, not in any cluster yet
+    * @param faces:         faces of the mesh
+    * @param normals:       normal of every face
+    * @param around:        faces around every vertex
+    * @param queued:        cluster every face was last queued for
+    * @param used:          cluster every vertex was last added to
+    */
+    void Grow(Set & set, int seed, const std::vector<CS250Parser::Face> & faces, const std::vector<Vector4> & normals,
+              const Adjacency & around, std::vector<int> & queued, std::vector<int> & used)
+    {
+        const int index = static_cast<int>(set.clusters.size());
+
+        Cluster cluster = {};
+        cluster.first_face   = static_cast<int>(set.faces.size());
+        cluster.first_vertex = static_cast<int>(set.vertices.size());
+
+        Vector4 normal_sum(0.f, 0.f, 0.f);
+        std::vector<int> queue(1, seed);
+        queued[seed] = index;
+
+        for (size_t head = 0; head < queue.size() && cluster.faces < MAX_FACES; head++)
+        {
+            const int face = queue[head];
+
+            //Only the faces that turn like the ones already in
+            if (cluster.faces > 0)
+            {
+                Vector4 axis = normal_sum;
+                axis.Normalize();
+                if (normals[face].Dot(axis) < MIN_NORMAL_DOT)
+                    continue;
+            }
+
+            //Vertices the face would add, each one once
+            const int * indices = faces[face].indices;
+            int added = 0;
+            for (int j = 0; j < 3; j++)
+            {
+                bool repeated = false;
+                for (int k = 0; k < j; k++)
+                    repeated = repeated || indices[k] == indices[j];
+
+                if (!repeated && used[indices[j]] != index)
+                    added++;
+            }
+            if (cluster.vertices + added > MAX_VERTICES)
+                continue;
+
+            set.cluster_of[face] = index;
+            set.faces.push_back(face);
+            cluster.faces++;
+            normal_sum += normals[face];
+
+            for (int j = 0; j < 3; j++)
+            {
+                int vertex = faces[face].indices[j];
+                if (used[vertex] != index)
+                {
+                    used[vertex] = index;
+                    set.vertices.push_back(vertex);
+                    cluster.vertices++;
+                }
+
+                //The faces that share a vertex with this one are the next ones to try
+                for (int i = around.start[vertex]; i < around.start[vertex + 1]; i++)
+                {
+                    int next = around.faces[i];
+                    if (set.cluster_of[next] < 0 && queued[next] != index)
+                    {
+                        queued[next] = index;
+                        queue.push_back(next);
+                    }
+                }
+            }
+        }
+
+        set.clusters.push_back(cluster);
+    }
+
+    /**
+    * @brief FitBounds: sphere and normal cone of a cluster
+    *
+    * @param set:       set with the faces and vertices of the cluster
+    * @param cluster:   cluster to fit
+    * @param vertices:  vertices of the mesh
+    * @param faces:     faces of the mesh
+    * @param normals:   normal of every face
+    */
+    void FitBounds(const Set & set, Cluster & cluster, const std::vector<Point4> & vertices,
+                   const std::vector<CS250Parser::Face> & faces, const std::vector<Vector4> & normals)
+    {
+        //Sphere around the box of the vertices
+        float low[3], high[3];
+        for (int axis = 0; axis < 3; axis++)
+        {
+            low[axis] = high[axis] = vertices[set.vertices[cluster.first_vertex]].v[axis];
+            for (int i = 0; i < cluster.vertices; i++)
+            {
+                low[axis]  = std::min(low[axis], vertices[set.vertices[cluster.first_vertex + i]].v[axis]);
+                high[axis] = std::max(high[axis], vertices[set.vertices[cluster.first_vertex + i]].v[axis]);
+            }
+        }
+        cluster.center = Point4(0.5f * (low[0] + high[0]), 0.5f * (low[1] + high[1]), 0.5f * (low[2] + high[2]));
+
+        cluster.radius = 0.f;
+        for (int i = 0; i < cluster.vertices; i++)
+            cluster.radius = std::max(cluster.radius, (vertices[set.vertices[cluster.first_vertex + i]] - cluster.center).Length());
+
+        //Cone around the average normal, wider than a right angle can't be used
+        cluster.axis = Vector4(0.f, 0.f, 0.f);
+        for (int i = 0; i < cluster.faces; i++)
+            cluster.axis += normals[set.faces[cluster.first_face + i]];
+        cluster.axis.Normalize();
+
+        cluster.cos_spread = cluster.axis.LengthSq() > 0.f ? 1.f : -1.f;
+        for (int i = 0; i < cluster.faces; i++)
+            cluster.cos_spread = std::min(cluster.cos_spread, cluster.axis.Dot(normals[set.faces[cluster.first_face + i]]));
+        cluster.sin_spread = std::sqrt(std::max(0.f, 1.f - cluster.cos_spread * cluster.cos_spread));
+
+        //Apex of the cone, moved back along the axis until it is behind the plane of every face
+        float back = 0.f;
+        for (int i = 0; i < cluster.faces; i++)
+        {
+            const int       face   = set.faces[cluster.first_face + i];
+            const Vector4 & normal = normals[face];
+            float along = cluster.axis.Dot(normal);
+            if (along > 0.f)
+                back = std::max(back, (cluster.center - vertices[faces[face].indices[0]]).Dot(normal) / along);
+        }
+        cluster.apex = cluster.center - cluster.axis * back;
+    }
+}
+
+
+/**
+* @brief Build:     split the faces of a mesh into clusters, every face in one of them
+*
+* @param set:       clusters of the mesh, anything in it is replaced
+* @param vertices:  vertices of the mesh
+* @param faces:     faces of the mesh, counterclockwise from the outside
+*/
+void Build(Set & set, const std::vector<Point4> & vertices, const std::vector<CS250Parser::Face> & faces)
+{
+    const int vertex_count = static_cast<int>(vertices.size());
+    const int face_count   = static_cast<int>(faces.size());
+
+    set.clusters.clear();
+    set.faces.clear();
+    set.vertices.clear();
+    set.cluster_of.assign(face_count, -1);
+
+    //Normal of every face, none for the ones without area
+    std::vector<Vector4> normals(face_count);
+    for (int f = 0; f < face_count; f++)
+    {
+        const Point4 & a = vertices[faces[f].indices[0]];
+        normals[f] = (vertices[faces[f].indices[1]] - a).Cross(vertices[faces[f].indices[2]] - a);
+        normals[f].Normalize();
+    }
+
+    //Faces around every vertex
+    Adjacency around;
+    around.start.assign(vertex_count + 1, 0);
+    for (const CS250Parser::Face & face : faces)
+    {
+        for (int j = 0; j < 3; j++)
+            around.start[face.indices[j] + 1]++;
+    }
+    for (int v = 0; v < vertex_count; v++)
+        around.start[v + 1] += around.start[v];
+
+    around.faces.resize(3 * face_count);
+    std::vector<int> fill(around.start.begin(), around.start.end() - 1);
+    for (int f = 0; f < face_count; f++)
+    {
+        for (int j = 0; j < 3; j++)
+            around.faces[fill[faces[f].indices[j]]++] = f;
+    }
+
+    //Every face not taken yet starts a cluster, in the order of the mesh
+    std::vector<int> queued(face_count, -1);
+    std::vector<int> used(vertex_count, -1);
+    for (int f = 0; f < face_count; f++)
+    {
+        if (set.cluster_of[f] < 0)
+            Grow(set, f, faces, normals, around, queued, used);
+    }
+
+    for (Cluster & cluster : set.clusters)
+        FitBounds(set, cluster, vertices, faces, normals);
+}
+
+/**
+* @brief Outside:   whether the sphere of a cluster is completely outside of a plane of a frustum
+*
+* @param cluster:   cluster to test
+* @param frustum:   planes of the frustum in the space of the mesh
+* @return           true if nothing of the cluster can be in the frustum
+*/
+bool Outside(const Cluster & cluster, const Bvh::Frustum & frustum)
+{
+    for (const Bvh::Plane & plane : frustum.planes)
+    {
+        //The planes are not normalized, the distance is scaled by the length of the normal
+        float length   = std::sqrt(plane.a * plane.a + plane.b * plane.b + plane.c * plane.c);
+        float distance = plane.a * cluster.center.x + plane.b * cluster.center.y + plane.c * cluster.center.z + plane.d;
+        if (distance < -cluster.radius * length)
+            return true;
+    }
+    return false;
+}
+
+/**
+* @brief FacesAway: whether the camera is behind the plane of every face of a cluster. Every
+*                   face is in front of the apex, so the camera is behind it if the apex is
+*                   in front of the camera along its normal. That holds for every normal
+*                   when the direction to the apex is less than a right angle minus the
+*                   spread from the axis
+*
+* @param cluster:   cluster to test
+* @param eye:       position of the camera in the space of the mesh
+* @return           true if every face of the cluster is a back face
+*/
+bool FacesAway(const Cluster & cluster, const Point4 & eye)
+{
+    if (cluster.cos_spread <= 0.f)
+        return false;
+
+    Vector4 to_apex = cluster.apex - eye;
+    return to_apex.Dot(cluster.axis) > cluster.sin_spread * to_apex.Length();
+}
+
+} // namespace Meshlet
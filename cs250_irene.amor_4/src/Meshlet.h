@@ -0,0 +1,66 @@
+/****************************************************************************************/
+/*!
+\file   Meshlet.h
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+Clusters of the faces of a mesh, made when the scene is loaded. Every cluster
+grows from a face to the faces around it that turn the same way, up to a fixed
+number of faces and vertices, and keeps a sphere around its vertices and a cone
+around the normals of its faces. A whole cluster can then be skipped before its
+vertices are transformed, if its sphere is outside of the frustum or if the
+camera is behind every one of its faces. Small clusters turn less, so more of
+the back ones can be skipped.
+Functions include:	Build, Outside, FacesAway
+
+*/
+/****************************************************************************************/
+
+#pragma once
+
+#include "CS250Parser.h"
+#include "Bvh.h"
+#include "Math/Point4.h"
+#include "Math/Vector4.h"
+#include <vector>
+
+namespace Meshlet
+{
+
+const int   MAX_FACES      = 16;    // faces of a cluster at most
+const int   MAX_VERTICES   = 16;    // vertices of a cluster at most
+const float MIN_NORMAL_DOT = 0.5f;  // faces join a cluster turning at most 60 degrees from its normal
+
+struct Cluster
+{
+    int     first_face, faces;          // in the face list of the set
+    int     first_vertex, vertices;     // in the vertex list of the set
+    Point4  center;                     // sphere around the vertices
+    float   radius;
+    Vector4 axis;                       // cone around the normals of the faces
+    float   cos_spread, sin_spread;     // angle from the axis to the farthest normal
+    Point4  apex;                       // on the axis, behind the plane of every face
+};
+
+struct Set
+{
+    std::vector<Cluster> clusters;
+    std::vector<int>     faces;         // faces of the mesh, one cluster after the other
+    std::vector<int>     vertices;      // vertices of the mesh each cluster uses
+    std::vector<int>     cluster_of;    // cluster of every face of the mesh
+};
+
+// Make the clusters of a mesh
+void Build(Set & set, const std::vector<Point4> & vertices, const std::vector<CS250Parser::Face> & faces);
+
+// Whether the sphere of a cluster is completely outside of a plane, the planes in model space
+bool Outside(const Cluster & cluster, const Bvh::Frustum & frustum);
+
+// Whether the camera is behind every face of a cluster, the camera in model space
+bool FacesAway(const Cluster & cluster, const Point4 & eye);
+
+} // namespace Meshlet
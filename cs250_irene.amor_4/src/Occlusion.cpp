@@ -0,0 +1,249 @@
+/****************************************************************************************/
+/*!
+\file   Occlusion.cpp
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+This file contains the implementation of the occlusion buffer.
+Functions include:	Clear, DrawOccluder, IsHidden, Clamp, Cross, ConvexHull, Span
+
+*/
+/****************************************************************************************/
+
+#include "Occlusion.h"  //Header file
+#include <algorithm>    //sort, fill
+#include <cfloat>       //FLT_MAX
+#include <cmath>        //floor, ceil
+
+namespace Occlusion
+{
+
+namespace
+{
+    const float SHRINK = 0.01f;     //Pixels the outline is moved in, against the rounding
+
+    struct Corner
+    {
+        float x, y;
+    };
+
+    /**
+    * @brief Clamp: whole value of a cell coordinate kept inside [low, high], even if it is huge
+    */
+    int Clamp(float value, int low, int high)
+    {
+        if (!(value > low))
+            return low;
+        if (value > high)
+            return high;
+        return static_cast<int>(value);
+    }
+
+    /**
+    * @brief Cross: z of the cross product of a->b and a->c, positive if c is on the left
+    */
+    float Cross(const Corner & a, const Corner & b, const Corner & c)
+    {
+        return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    }
+
+    /**
+    * @brief ConvexHull:    outline of a set of points, sorted in place (monotone chain)
+    *
+    * @param points:        points, sorted by the function
+    * @param count:         points in the set
+    * @param hull:          room for count + 1 corners
+    * @return               corners of the outline
+    */
+    int ConvexHull(Corner * points, int count, Corner * hull)
+    {
+        std::sort(points, points + count, [](const Corner & a, const Corner & b)
+        {
+            return a.x < b.x || (a.x == b.x && a.y < b.y);
+        });
+
+        int size = 0;
+
+        //Lower half, then the upper half
+        for (int i = 0; i < count; i++)
+        {
+            while (size >= 2 && Cross(hull[size - 2], hull[size - 1], points[i]) <= 0.f)
+                size--;
+            hull[size++] = points[i];
+        }
+        for (int i = count - 2, lower = size + 1; i >= 0; i--)
+        {
+            while (size >= lower && Cross(hull[size - 2], hull[size - 1], points[i]) <= 0.f)
+                size--;
+            hull[size++] = points[i];
+        }
+
+        //The first corner was added again at the end
+        return size > 1 ? size - 1 : size;
+    }
+
+    /**
+    * @brief Span:      part of a horizontal line inside of a convex outline
+    *
+    * @param hull:      corners of the outline
+    * @param count:     corners of the outline
+    * @param y:         line
+    * @param left:      first x inside
+    * @param right:     last x inside
+    * @return           false if the line misses the outline
+    */
+    bool Span(const Corner * hull, int count, float y, float & left, float & right)
+    {
+        left  = FLT_MAX;
+        right = -FLT_MAX;
+
+        for (int i = 0; i < count; i++)
+        {
+            const Corner & a = hull[i];
+            const Corner & b = hull[(i + 1) % count];
+
+            if ((y < a.y && y < b.y) || (y > a.y && y > b.y))
+                continue;
+
+            float x0 = a.x, x1 = b.x;
+            if (a.y != b.y)
+                x0 = x1 = a.x + (y - a.y) * (b.x - a.x) / (b.y - a.y);
+
+            left  = std::min(left, std::min(x0, x1));
+            right = std::max(right, std::max(x0, x1));
+        }
+
+        left  += SHRINK;
+        right -= SHRINK;
+        return left <= right;
+    }
+}
+
+
+/**
+* @brief Clear:     empty the buffer, nothing covers any cell
+*
+* @param buffer:    buffer to clear
+* @param x, y:      top left pixel of the rectangle of the screen it covers
+* @param w, h:      size of the rectangle
+*/
+void Clear(Buffer & buffer, int x, int y, int w, int h)
+{
+    buffer.x           = x;
+    buffer.y           = y;
+    buffer.cell_width  = static_cast<float>(w) / WIDTH;
+    buffer.cell_height = static_cast<float>(h) / HEIGHT;
+
+    buffer.depth.resize(WIDTH * HEIGHT);
+    std::fill(buffer.depth.begin(), buffer.depth.end(), FLT_MAX);
+}
+
+/**
+* @brief DrawOccluder:  cover the cells that are completely inside of the outline of the points
+*                       with the depth of the farthest point. Only right for convex objects
+*
+* @param buffer:        buffer to draw to
+* @param points:        screen x and y and depth of every point of the object
+* @param count:         points of the object, up to MAX_POINTS
+*/
+void DrawOccluder(Buffer & buffer, const Point4 * points, int count)
+{
+    if (count < 3 || count > MAX_POINTS)
+        return;
+
+    //Outline in cells, and the farthest depth
+    Corner corners[MAX_POINTS];
+    Corner hull[MAX_POINTS + 1];
+    float  z = -FLT_MAX;
+    for (int i = 0; i < count; i++)
+    {
+        corners[i].x = (points[i].x - buffer.x) / buffer.cell_width;
+        corners[i].y = (points[i].y - buffer.y) / buffer.cell_height;
+        z = std::max(z, points[i].z);
+    }
+
+    int size = ConvexHull(corners, count, hull);
+    if (size < 3)
+        return;
+
+    float top = FLT_MAX, bottom = -FLT_MAX;
+    for (int i = 0; i < size; i++)
+    {
+        top    = std::min(top, hull[i].y);
+        bottom = std::max(bottom, hull[i].y);
+    }
+
+    //The rows between two lines inside of the outline
+    int first_row = Clamp(std::ceil(top), 0, HEIGHT);
+    int last_row  = Clamp(std::floor(bottom), 0, HEIGHT) - 1;
+
+    float left_above, right_above;
+    bool  inside_above = first_row <= last_row && Span(hull, size, static_cast<float>(first_row), left_above, right_above);
+
+    for (int row = first_row; row <= last_row; row++)
+    {
+        float left_below, right_below;
+        bool  inside_below = Span(hull, size, static_cast<float>(row + 1), left_below, right_below);
+
+        //Convex: a cell is inside if its top and bottom edges are
+        if (inside_above && inside_below)
+        {
+            int first = Clamp(std::ceil(std::max(left_above, left_below)), 0, WIDTH);
+            int last  = Clamp(std::floor(std::min(right_above, right_below)), 0, WIDTH) - 1;
+
+            float * depth = &buffer.depth[row * WIDTH];
+            for (int col = first; col <= last; col++)
+                depth[col] = std::min(depth[col], z);
+        }
+
+        left_above   = left_below;
+        right_above  = right_below;
+        inside_above = inside_below;
+    }
+}
+
+/**
+* @brief IsHidden:      whether every cell a rectangle touches is covered nearer than a depth
+*
+* @param buffer:        occluders
+* @param left, top:     top left corner of the rectangle, in screen pixels
+* @param right, bottom: bottom right corner of the rectangle
+* @param z:             nearest depth of what is inside of the rectangle
+* @return               true if nothing of the rectangle can be seen
+*/
+bool IsHidden(const Buffer & buffer, float left, float top, float right, float bottom, float z)
+{
+    if (buffer.depth.empty())
+        return false;
+
+    //Cells touched, the parts outside of the buffer are not seen at all
+    float first_x = std::floor((left - buffer.x) / buffer.cell_width);
+    float last_x  = std::floor((right - buffer.x) / buffer.cell_width);
+    float first_y = std::floor((top - buffer.y) / buffer.cell_height);
+    float last_y  = std::floor((bottom - buffer.y) / buffer.cell_height);
+    if (last_x < 0.f || first_x >= WIDTH || last_y < 0.f || first_y >= HEIGHT)
+        return true;
+
+    int first_col = Clamp(first_x, 0, WIDTH - 1);
+    int last_col  = Clamp(last_x, 0, WIDTH - 1);
+    int first_row = Clamp(first_y, 0, HEIGHT - 1);
+    int last_row  = Clamp(last_y, 0, HEIGHT - 1);
+
+    for (int row = first_row; row <= last_row; row++)
+    {
+        const float * depth = &buffer.depth[row * WIDTH];
+        for (int col = first_col; col <= last_col; col++)
+        {
+            if (depth[col] >= z)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace Occlusion
@@ -0,0 +1,52 @@
+/****************************************************************************************/
+/*!
+\file   Occlusion.h
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+Low resolution depth buffer of the large objects near the camera, to skip the
+objects that are hidden behind them before their triangles are drawn. Both
+sides are conservative: an occluder only covers the cells that are completely
+inside of its outline, with the depth of its farthest point, and an object is
+only hidden if every cell its rectangle touches is covered by something nearer
+than its nearest point.
+Functions include:	Clear, DrawOccluder, IsHidden
+
+*/
+/****************************************************************************************/
+
+#pragma once
+
+#include "Math/Point4.h"
+#include <vector>
+
+namespace Occlusion
+{
+
+const int WIDTH      = 256;     // cells of the buffer, whatever the size of the view
+const int HEIGHT     = 192;
+const int MAX_POINTS = 64;      // most points of an occluder
+
+struct Buffer
+{
+    int                x           = 0;     // screen rectangle the cells cover
+    int                y           = 0;
+    float              cell_width  = 1.f;   // screen pixels of a cell
+    float              cell_height = 1.f;
+    std::vector<float> depth;               // depth every point of the cell is covered at, or more
+};
+
+// Empty the buffer and make it cover a rectangle of the screen
+void Clear(Buffer & buffer, int x, int y, int w, int h);
+
+// Draw the outline of a convex object, given by the screen position and depth of its points
+void DrawOccluder(Buffer & buffer, const Point4 * points, int count);
+
+// Whether a rectangle of the screen is covered by occluders nearer than z
+bool IsHidden(const Buffer & buffer, float left, float top, float right, float bottom, float z);
+
+} // namespace Occlusion
@@ -0,0 +1,201 @@
+/****************************************************************************************/
+/*!
+\file   PerfCounters.cpp
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+This file contains the implementation of the hardware performance counters.
+Functions include:	Open, Close, IsAvailable, Read, GetName, OpenEvent
+
+*/
+/****************************************************************************************/
+
+#include "PerfCounters.h"   //Header file
+
+#ifdef CS250_PROFILE
+
+#include <cstdio>
+#include <cstring>          //memset
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+bool            PerfCounters::open = false;
+std::thread::id PerfCounters::owner;
+
+namespace
+{
+    const char * NAMES[PerfCounters::CounterCount] =
+    {
+        "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses"
+    };
+
+    //Position of every counter in the values of the group, -1 if it could not be opened
+    int slots[PerfCounters::CounterCount];
+    int fds[PerfCounters::CounterCount];
+    int slot_count = 0;
+
+#ifdef __linux__
+    int leader = -1;        //The whole group is read from the first counter opened
+
+    /**
+    * @brief OpenEvent: open a counter of the calling thread, in user mode only
+    */
+    int OpenEvent(unsigned type, unsigned long long config, int group)
+    {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size           = sizeof(attr);
+        attr.type           = type;
+        attr.config         = config;
+        attr.disabled       = group == -1;      //The leader starts the whole group
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, group, 0));
+    }
+#endif
+}
+
+
+/**
+* @brief Open:      start counting on the calling thread
+*
+* @return           whether any counter could be opened
+*/
+bool PerfCounters::Open()
+{
+    Close();
+
+#ifdef __linux__
+    const unsigned long long l1d_read_miss = PERF_COUNT_HW_CACHE_L1D |
+                                             (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                             (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+    const struct { unsigned type; unsigned long long config; } EVENTS[CounterCount] =
+    {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HW_CACHE, l1d_read_miss},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    };
+
+    //The counters that the CPU or the kernel don't allow are skipped
+    for (int i = 0; i < CounterCount; i++)
+    {
+        fds[i] = OpenEvent(EVENTS[i].type, EVENTS[i].config, leader);
+        if (fds[i] < 0)
+            continue;
+
+        if (leader == -1)
+            leader = fds[i];
+        slots[i] = slot_count++;
+    }
+
+    if (leader == -1)
+    {
+        fprintf(stderr, "Could not open the performance counters (check /proc/sys/kernel/perf_event_paranoid)\n");
+        return false;
+    }
+
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+
+    open  = true;
+    owner = std::this_thread::get_id();
+    return true;
+#else
+    fprintf(stderr, "Performance counters are only available on Linux\n");
+    return false;
+#endif
+}
+
+/**
+* @brief Close:     stop counting
+*
+* @param (void)
+*/
+void PerfCounters::Close()
+{
+#ifdef __linux__
+    for (int i = 0; i < CounterCount; i++)
+    {
+        if (open && slots[i] >= 0)
+            close(fds[i]);
+    }
+    leader = -1;
+#endif
+
+    for (int i = 0; i < CounterCount; i++)
+    {
+        slots[i] = -1;
+        fds[i]   = -1;
+    }
+
+    slot_count = 0;
+    open       = false;
+}
+
+/**
+* @brief IsAvailable:   whether a counter is being counted
+*
+* @param counter:       counter to check
+* @return               true if it could be opened
+*/
+bool PerfCounters::IsAvailable(Counter counter)
+{
+    return open && slots[counter] >= 0;
+}
+
+/**
+* @brief Read:      read every counter at once
+*
+* @param values:    counts since Open, 0 for the counters not available
+*/
+void PerfCounters::Read(unsigned long long values[CounterCount])
+{
+    for (int i = 0; i < CounterCount; i++)
+        values[i] = 0;
+
+#ifdef __linux__
+    if (!open)
+        return;
+
+    //Number of counters, time enabled, time running, then the values
+    unsigned long long data[3 + CounterCount];
+    if (read(leader, data, sizeof(data)) < static_cast<ssize_t>((3 + slot_count) * sizeof(data[0])))
+        return;
+
+    //Scale up when the group did not fit on the PMU all the time
+    double scale = data[2] ? static_cast<double>(data[1]) / data[2] : 0.0;
+
+    for (int i = 0; i < CounterCount; i++)
+    {
+        if (slots[i] >= 0)
+            values[i] = static_cast<unsigned long long>(data[3 + slots[i]] * scale);
+    }
+#endif
+}
+
+/**
+* @brief GetName:   name of a counter, as used in the CSV file
+*
+* @param counter:   counter
+* @return           name of the counter
+*/
+const char * PerfCounters::GetName(Counter counter)
+{
+    return NAMES[counter];
+}
+
+#endif
@@ -0,0 +1,53 @@
+/****************************************************************************************/
+/*!
+\file   PerfCounters.h
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+Hardware performance counters of the thread that renders, read around every
+profiler stage to tell apart the stages that are compute bound (high IPC) from
+the ones that are memory bound (cache misses per pixel).
+
+The counters use perf_event_open, so they are only available on Linux, and like
+the profiler they only exist when CS250_PROFILE is defined. On other platforms
+Open fails and the profiler only shows the times.
+Functions include:	Open, Close, IsOpen, IsAvailable, Read, GetName
+
+*/
+/****************************************************************************************/
+
+#pragma once
+
+#ifdef CS250_PROFILE
+
+#include <thread>
+
+class PerfCounters
+{
+  public:
+    enum Counter
+    {
+        cycles, instructions, l1d_misses, llc_misses, branch_misses,
+        CounterCount
+    };
+
+    static bool Open();
+    static void Close();
+    // Only the thread that opened the counters can read them
+    static bool IsOpen() { return open && owner == std::this_thread::get_id(); }
+    static bool IsAvailable(Counter counter);
+
+    // Counts of the calling thread since Open, scaled if the kernel had to multiplex them
+    static void         Read(unsigned long long values[CounterCount]);
+    static const char * GetName(Counter counter);
+
+  private:
+    static bool            open;
+    static std::thread::id owner;
+};
+
+#endif
@@ -0,0 +1,117 @@
+/****************************************************************************************/
+/*!
+\file   Pipeline.cpp
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+This file contains the implementation of the simulation and render pipeline.
+Functions include:	Pipeline, ~Pipeline, BeginFrame, EndFrame, Stop, SimulationLoop,
+					Elapsed
+
+*/
+/****************************************************************************************/
+
+#include "Pipeline.h"   //Header file
+
+/**
+* @brief Pipeline:      start simulating
+*
+* @param airplane:      initialized airplane scene
+* @param threaded:      simulate on another thread, one frame ahead of the renderer
+* @param frame_time:    seconds between frames, 0 for the time that really passes
+*/
+Pipeline::Pipeline(Airplane & airplane, bool threaded, double frame_time)
+    : airplane(airplane), threaded(threaded), frame_time(frame_time),
+      last_frame(std::chrono::steady_clock::now()), queue(SNAPSHOTS)
+{
+    if (threaded)
+        simulation = std::thread(&Pipeline::SimulationLoop, this);
+}
+
+/**
+* @brief ~Pipeline: stop the simulation thread
+*/
+Pipeline::~Pipeline()
+{
+    Stop();
+}
+
+/**
+* @brief BeginFrame:    get the next simulated frame
+*
+* @return               snapshot to render, nullptr once stopped
+*/
+const Airplane::Snapshot * Pipeline::BeginFrame()
+{
+    //Simulate the frame right now
+    if (!threaded)
+    {
+        airplane.Simulate(snapshots[0], Elapsed());
+        return &snapshots[0];
+    }
+
+    int slot = queue.BeginConsume();
+    return slot >= 0 ? &snapshots[slot] : nullptr;
+}
+
+/**
+* @brief EndFrame:  the rendered snapshot can be simulated into again
+*
+* @param (void)
+*/
+void Pipeline::EndFrame()
+{
+    if (threaded)
+        queue.EndConsume();
+}
+
+/**
+* @brief Stop:      wait for the simulation thread to finish its frame, the
+*                   airplane can be used again once this returns
+*
+* @param (void)
+*/
+void Pipeline::Stop()
+{
+    queue.Stop();
+
+    if (simulation.joinable())
+        simulation.join();
+}
+
+/**
+* @brief SimulationLoop:    simulate frames as long as there is a free snapshot
+*
+* @param (void)
+*/
+void Pipeline::SimulationLoop()
+{
+    TRACE_THREAD_NAME("simulation");
+
+    for (int slot = queue.BeginProduce(); slot >= 0; slot = queue.BeginProduce())
+    {
+        airplane.Simulate(snapshots[slot], Elapsed());
+        queue.EndProduce();
+    }
+}
+
+/**
+* @brief Elapsed:   time between the frame about to be simulated and the last one
+*
+* @return           seconds to simulate
+*/
+double Pipeline::Elapsed()
+{
+    if (frame_time > 0.0)
+        return frame_time;
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(now - last_frame).count();
+    last_frame = now;
+
+    return elapsed;
+}
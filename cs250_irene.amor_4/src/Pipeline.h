@@ -0,0 +1,62 @@
+/****************************************************************************************/
+/*!
+\file   Pipeline.h
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+Runs the simulation of the airplane one frame ahead of the renderer. A thread
+simulates frame N+1 into a snapshot while the renderer draws frame N from the
+previous one, and the snapshots are handed over by a FrameQueue. Once it is a
+frame ahead, the simulation thread sleeps until the renderer gives a snapshot
+back, and the renderer sleeps while it waits for a simulated frame.
+
+Without the thread each frame is simulated right before it is rendered, as
+Airplane_Update does. Both ways render the same frames.
+
+The frames can be a fixed time apart, so that every run renders the same
+frames, or as far apart as the clock says, so the airplane moves at the same
+speed whatever the frame rate.
+Functions include:	Pipeline, ~Pipeline, BeginFrame, EndFrame, Stop, SimulationLoop,
+					Elapsed
+
+*/
+/****************************************************************************************/
+
+#pragma once
+
+#include "AirplaneFunctions.h"
+#include "FrameQueue.h"
+#include <thread>
+#include <chrono>
+
+class Pipeline
+{
+  public:
+    Pipeline(Airplane & airplane, bool threaded, double frame_time);
+    ~Pipeline();
+
+    // Snapshot of the next frame to render, waits for its simulation. nullptr once stopped
+    const Airplane::Snapshot * BeginFrame();
+    void                       EndFrame();
+
+    // Stop simulating, the frames already simulated are not rendered
+    void Stop();
+
+  private:
+    void   SimulationLoop();
+    double Elapsed();
+
+    static const int SNAPSHOTS = 2;     //The one being rendered and the one being simulated
+
+    Airplane &         airplane;
+    bool               threaded;
+    double             frame_time;      //Seconds between frames, 0 to use the clock
+    std::chrono::steady_clock::time_point last_frame;
+    Airplane::Snapshot snapshots[SNAPSHOTS];
+    FrameQueue         queue;
+    std::thread        simulation;
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdio>
+#include <cerrno>
+#include <cstdlib>
+
+#ifdef _MSC_VER
+#include <malloc.h>     // _aligned_malloc
+#endif
+
+// The buffer of a %s conversion of fscanf_s, its size only for the secure CRT.
+// The format needs a width of one less than the size so fscanf is bounded too
+#ifdef _MSC_VER
+#define SCANF_BUFFER(buffer, size) buffer, static_cast<unsigned>(size)
+#else
+#define SCANF_BUFFER(buffer, size) buffer
+#endif
+
+// The project uses the MSVC secure CRT functions (fopen_s, fscanf_s).
+// On other compilers map them onto the standard ones so the offscreen
+// modes can also be built on the Linux render nodes.
+#ifndef _MSC_VER
+
+inline int fopen_s(FILE ** file, const char * filename, const char * mode)
+{
+    *file = std::fopen(filename, mode);
+    return *file ? 0 : errno;
+}
+
+// Only for formats without strings, fscanf takes no buffer sizes
+#define fscanf_s fscanf
+#define sscanf_s sscanf
+
+inline void * _aligned_malloc(size_t size, size_t alignment)
+{
+    void * memory = nullptr;
+    return posix_memalign(&memory, alignment, size) == 0 ? memory : nullptr;
+}
+
+inline void _aligned_free(void * memory)
+{
+    std::free(memory);
+}
+
+#endif
@@ -0,0 +1,502 @@
+/****************************************************************************************/
+/*!
+\file   Profiler.cpp
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+This file contains the implementation of the frame profiler.
+Functions include:	Reset, BeginFrame, EndFrame, Add, AddCounters, GetStats,
+					GetCounterStats, GetName, GetFrameAllocations, OpenCSV, CloseCSV,
+					DrawOverlay, WriteCSVHeader, DrawText
+
+*/
+/****************************************************************************************/
+
+#include "Profiler.h"       //Header file
+
+#ifdef CS250_PROFILE
+
+#include "FrameBuffer.h"    //Overlay
+#include "Rasterizer.h"     //Pipeline counters
+#include "Platform.h"       //fopen_s outside of MSVC
+#include <algorithm>        //nth_element
+#include <atomic>
+#include <cctype>           //toupper
+#include <cstdlib>          //malloc
+#include <new>              //bad_alloc
+
+//Every heap allocation of the program, to check that the frames don't allocate
+namespace
+{
+    std::atomic<unsigned long long> heap_allocations(0);
+
+    void * CountedAllocation(size_t size)
+    {
+        heap_allocations.fetch_add(1, std::memory_order_relaxed);
+
+        void * memory = std::malloc(size ? size : 1);
+        if (!memory)
+            throw std::bad_alloc();
+        return memory;
+    }
+}
+
+void * operator new(size_t size)                    { return CountedAllocation(size); }
+void * operator new[](size_t size)                  { return CountedAllocation(size); }
+void   operator delete(void * memory) noexcept      { std::free(memory); }
+void   operator delete[](void * memory) noexcept    { std::free(memory); }
+void   operator delete(void * memory, size_t) noexcept      { std::free(memory); }
+void   operator delete[](void * memory, size_t) noexcept    { std::free(memory); }
+
+namespace
+{
+    typedef std::chrono::high_resolution_clock clock;
+
+    const int HISTORY = 240;                            //Frames used for the statistics
+
+    std::atomic<double> current[Profiler::StageCount];  //Milliseconds of each stage in this frame, from any thread
+    float             history[HISTORY][Profiler::StageCount];
+    unsigned          frames = 0;                       //Frames finished
+    clock::time_point frame_start;
+    FILE *            csv = nullptr;
+    bool              csv_header = false;               //Written with the first frame, once the counters are known
+
+    //Hardware counters of each stage in this frame and in the last frames
+    typedef unsigned long long Counts[PerfCounters::CounterCount];
+    Counts             current_counts[Profiler::StageCount];
+    Counts             history_counts[HISTORY][Profiler::StageCount];
+    unsigned long long history_pixels[HISTORY];         //Pixels tested in each frame
+    Counts             frame_counts;                    //Counters at the start of the frame
+
+    const char * NAMES[Profiler::StageCount] =
+    {
+        "input", "model_to_world", "camera", "frustum", "vertex", "occlusion", "sort", "prepass", "raster", "shade",
+        "clear", "convert", "upload", "display", "frame"
+    };
+
+    //3x5 font for the overlay, one row of 3 bits per line (left pixel is the high bit)
+    //Characters: A-Z, 0-9, '.', ':', '-', '_', '/', '%'
+    const unsigned char FONT_LETTERS[26][5] =
+    {
+        {2,5,7,5,5}, {6,5,6,5,6}, {3,4,4,4,3}, {6,5,5,5,6}, {7,4,6,4,7}, {7,4,6,4,4},
+        {3,4,5,5,3}, {5,5,7,5,5}, {7,2,2,2,7}, {1,1,1,5,2}, {5,5,6,5,5}, {4,4,4,4,7},
+        {5,7,7,5,5}, {6,5,5,5,5}, {2,5,5,5,2}, {6,5,6,4,4}, {2,5,5,6,3}, {6,5,6,5,5},
+        {3,4,2,1,6}, {7,2,2,2,2}, {5,5,5,5,7}, {5,5,5,5,2}, {5,5,7,7,5}, {5,5,2,5,5},
+        {5,5,2,2,2}, {7,1,2,4,7}
+    };
+    const unsigned char FONT_DIGITS[10][5] =
+    {
+        {7,5,5,5,7}, {2,6,2,2,7}, {6,1,2,4,7}, {6,1,2,1,6}, {5,5,7,1,1},
+        {7,4,6,1,6}, {3,4,7,5,7}, {7,1,2,2,2}, {7,5,7,5,7}, {7,5,7,1,6}
+    };
+    const char          FONT_SYMBOLS[]       = ".:-_/%";
+    const unsigned char FONT_SYMBOL_ROWS[][5] =
+    {
+        {0,0,0,0,2}, {0,2,0,2,0}, {0,0,7,0,0}, {0,0,0,0,7}, {1,1,2,4,4}, {5,1,2,4,5}
+    };
+
+    //Heap allocations of the last frame
+    unsigned long long frame_allocations_start = 0;
+    unsigned long long frame_allocations       = 0;
+
+    //Pipeline counters shown next to the times
+    const int COUNTERS = 12;
+    const char * COUNTER_NAMES[COUNTERS] =
+    {
+        "tris_submitted", "tris_culled", "tris_occluded", "tris_simplified", "tris_clipped", "tris_rasterized",
+        "pixels_tested", "pixels_passed", "lines_stepped", "pixels_shaded", "prepass_tested",
+        "heap_allocs"
+    };
+
+    void GetCounters(unsigned long long values[COUNTERS])
+    {
+        const Rasterizer::Stats & stats = Rasterizer::stats;
+
+        values[0] = stats.triangles_submitted;
+        values[1] = stats.triangles_culled;
+        values[2] = stats.triangles_occluded;
+        values[3] = stats.triangles_simplified;
+        values[4] = stats.triangles_clipped;
+        values[5] = stats.triangles_rasterized;
+        values[6] = stats.pixels_tested;
+        values[7] = stats.pixels_passed;
+        values[8] = stats.lines_stepped;
+        values[9] = stats.pixels_shaded;
+        values[10] = stats.prepass_tested;
+        values[11] = frame_allocations;
+    }
+
+    const int FONT_SCALE = 2;                       //Screen pixels per font pixel
+    const int CHAR_WIDTH = 4 * FONT_SCALE;          //Glyph plus spacing
+    const int LINE_HEIGHT = 7 * FONT_SCALE;
+
+
+    /**
+    * @brief FillRect:  fill a rectangle of the framebuffer in front of everything
+    */
+    void FillRect(int x0, int y0, int w, int h, unsigned char r, unsigned char g, unsigned char b)
+    {
+        for (int y = y0; y < y0 + h; y++)
+            for (int x = x0; x < x0 + w; x++)
+                FrameBuffer::SetPixel(x, y, -1.f, r, g, b);
+    }
+
+    /**
+    * @brief DrawText:  draw a line of text with the overlay font
+    */
+    void DrawText(int x, int y, const char * text, unsigned char r, unsigned char g, unsigned char b)
+    {
+        for (; *text; text++, x += CHAR_WIDTH)
+        {
+            char c = static_cast<char>(toupper(static_cast<unsigned char>(*text)));
+
+            //Find the glyph
+            const unsigned char * rows = nullptr;
+            if (c >= 'A' && c <= 'Z')
+                rows = FONT_LETTERS[c - 'A'];
+            else if (c >= '0' && c <= '9')
+                rows = FONT_DIGITS[c - '0'];
+            else
+            {
+                for (int i = 0; FONT_SYMBOLS[i]; i++)
+                    if (FONT_SYMBOLS[i] == c)
+                        rows = FONT_SYMBOL_ROWS[i];
+            }
+
+            if (!rows)
+                continue;
+
+            for (int row = 0; row < 5; row++)
+                for (int col = 0; col < 3; col++)
+                    if (rows[row] & (4 >> col))
+                        FillRect(x + col * FONT_SCALE, y + row * FONT_SCALE, FONT_SCALE, FONT_SCALE, r, g, b);
+        }
+    }
+}
+
+
+/**
+* @brief Reset: forget the frames measured so far
+*
+* @param (void)
+*/
+void Profiler::Reset()
+{
+    frames = 0;
+}
+
+/**
+* @brief BeginFrame:    start timing a new frame
+*
+* @param (void)
+*/
+void Profiler::BeginFrame()
+{
+    for (int i = 0; i < StageCount; i++)
+        current[i].store(0.0, std::memory_order_relaxed);
+
+    if (PerfCounters::IsOpen())
+    {
+        for (int i = 0; i < StageCount; i++)
+            for (int c = 0; c < PerfCounters::CounterCount; c++)
+                current_counts[i][c] = 0;
+
+        PerfCounters::Read(frame_counts);
+    }
+
+    frame_allocations_start = heap_allocations.load(std::memory_order_relaxed);
+    frame_start = clock::now();
+}
+
+/**
+* @brief EndFrame:  store the times of the frame and export them
+*
+* @param (void)
+*/
+void Profiler::EndFrame()
+{
+    clock::time_point frame_end = clock::now();
+
+    frame_allocations = heap_allocations.load(std::memory_order_relaxed) - frame_allocations_start;
+
+    if (PerfCounters::IsOpen())
+        AddCounters(frame, frame_counts);
+
+    std::chrono::duration<double, std::milli> time = frame_end - frame_start;
+    current[frame].store(time.count(), std::memory_order_relaxed);
+
+    if (Trace::IsActive())
+        Trace::Record(NAMES[frame], frame_start, frame_end);
+
+    float * entry = history[frames % HISTORY];
+    for (int i = 0; i < StageCount; i++)
+        entry[i] = static_cast<float>(current[i].load(std::memory_order_relaxed));
+
+    if (PerfCounters::IsOpen())
+    {
+        std::copy(&current_counts[0][0], &current_counts[0][0] + StageCount * PerfCounters::CounterCount,
+                  &history_counts[frames % HISTORY][0][0]);
+        history_pixels[frames % HISTORY] = Rasterizer::stats.pixels_tested;
+    }
+
+    if (csv)
+    {
+        if (!csv_header)
+            WriteCSVHeader();
+
+        fprintf(csv, "%u", frames);
+        for (int i = 0; i < StageCount; i++)
+            fprintf(csv, ",%.4f", current[i].load(std::memory_order_relaxed));
+
+        unsigned long long counters[COUNTERS];
+        GetCounters(counters);
+        for (int i = 0; i < COUNTERS; i++)
+            fprintf(csv, ",%llu", counters[i]);
+
+        if (PerfCounters::IsOpen())
+        {
+            for (int i = 0; i < StageCount; i++)
+                for (int c = 0; c < PerfCounters::CounterCount; c++)
+                    fprintf(csv, ",%llu", current_counts[i][c]);
+        }
+        fprintf(csv, "\n");
+    }
+
+    frames++;
+}
+
+/**
+* @brief Add:       add time to a stage of the current frame, from any thread
+*
+* @param stage:     stage that was timed
+* @param ms:        milliseconds spent
+*/
+void Profiler::Add(Stage stage, double ms)
+{
+    double time = current[stage].load(std::memory_order_relaxed);
+    while (!current[stage].compare_exchange_weak(time, time + ms, std::memory_order_relaxed))
+        ;
+}
+
+/**
+* @brief AddCounters:   add the hardware counts since the start of a scope to a stage
+*
+* @param stage:         stage that was measured
+* @param start:         counters read at the start of the scope
+*/
+void Profiler::AddCounters(Stage stage, const unsigned long long start[PerfCounters::CounterCount])
+{
+    unsigned long long now[PerfCounters::CounterCount];
+    PerfCounters::Read(now);
+
+    for (int c = 0; c < PerfCounters::CounterCount; c++)
+        current_counts[stage][c] += now[c] - start[c];
+}
+
+/**
+* @brief GetStats:  statistics of a stage over the last frames
+*
+* @param stage:     stage to check
+* @param min:       minimum time, in milliseconds
+* @param avg:       average time
+* @param p99:       99th percentile
+*/
+void Profiler::GetStats(Stage stage, float & min, float & avg, float & p99)
+{
+    int count = static_cast<int>(std::min<unsigned>(frames, HISTORY));
+
+    min = avg = p99 = 0.f;
+    if (count == 0)
+        return;
+
+    float values[HISTORY];
+    for (int i = 0; i < count; i++)
+        values[i] = history[i][stage];
+
+    min = *std::min_element(values, values + count);
+
+    for (int i = 0; i < count; i++)
+        avg += values[i];
+    avg /= count;
+
+    int p = (count * 99) / 100;
+    if (p >= count)
+        p = count - 1;
+    std::nth_element(values, values + p, values + count);
+    p99 = values[p];
+}
+
+/**
+* @brief GetCounterStats:   hardware counters of a stage over the last frames
+*
+* @param stage:             stage to check
+* @param ipc:               instructions per cycle
+* @param l1d_per_pixel:     L1 data cache read misses per pixel tested
+* @param llc_per_pixel:     last level cache misses per pixel tested
+* @param branch_per_pixel:  branch mispredictions per pixel tested
+* @return                   whether the counters are open
+*/
+bool Profiler::GetCounterStats(Stage stage, float & ipc, float & l1d_per_pixel,
+                               float & llc_per_pixel, float & branch_per_pixel)
+{
+    ipc = l1d_per_pixel = llc_per_pixel = branch_per_pixel = 0.f;
+    if (!PerfCounters::IsOpen())
+        return false;
+
+    int count = static_cast<int>(std::min<unsigned>(frames, HISTORY));
+
+    //Totals of the last frames, so that the ratios are not dominated by a single frame
+    double totals[PerfCounters::CounterCount] = {};
+    double pixels = 0.0;
+    for (int i = 0; i < count; i++)
+    {
+        for (int c = 0; c < PerfCounters::CounterCount; c++)
+            totals[c] += static_cast<double>(history_counts[i][stage][c]);
+        pixels += static_cast<double>(history_pixels[i]);
+    }
+
+    if (totals[PerfCounters::cycles] > 0.0)
+        ipc = static_cast<float>(totals[PerfCounters::instructions] / totals[PerfCounters::cycles]);
+
+    if (pixels > 0.0)
+    {
+        l1d_per_pixel    = static_cast<float>(totals[PerfCounters::l1d_misses] / pixels);
+        llc_per_pixel    = static_cast<float>(totals[PerfCounters::llc_misses] / pixels);
+        branch_per_pixel = static_cast<float>(totals[PerfCounters::branch_misses] / pixels);
+    }
+
+    return true;
+}
+
+/**
+* @brief GetName:   name of a stage, as used in the CSV file
+*
+* @param stage:     stage
+* @return           name of the stage
+*/
+const char * Profiler::GetName(Stage stage)
+{
+    return NAMES[stage];
+}
+
+/**
+* @brief GetFrameAllocations:   heap allocations made during the last frame
+*
+* @return                       number of allocations
+*/
+unsigned long long Profiler::GetFrameAllocations()
+{
+    return frame_allocations;
+}
+
+/**
+* @brief OpenCSV:   export the stage times of every frame to a file
+*
+* @param filename:  CSV file to write
+* @return           whether the file could be opened
+*/
+bool Profiler::OpenCSV(const char * filename)
+{
+    CloseCSV();
+
+    fopen_s(&csv, filename, "w");
+    if (!csv)
+    {
+        fprintf(stderr, "Could not open %s\n", filename);
+        return false;
+    }
+
+    csv_header = false;
+    return true;
+}
+
+/**
+* @brief WriteCSVHeader:    write the names of the columns, all the times are in milliseconds
+*
+* @param (void)
+*/
+void Profiler::WriteCSVHeader()
+{
+    fprintf(csv, "frame_index");
+    for (int i = 0; i < StageCount; i++)
+        fprintf(csv, ",%s_ms", NAMES[i]);
+    for (int i = 0; i < COUNTERS; i++)
+        fprintf(csv, ",%s", COUNTER_NAMES[i]);
+
+    //Hardware counters of every stage
+    if (PerfCounters::IsOpen())
+    {
+        for (int i = 0; i < StageCount; i++)
+            for (int c = 0; c < PerfCounters::CounterCount; c++)
+                fprintf(csv, ",%s_%s", NAMES[i], PerfCounters::GetName(static_cast<PerfCounters::Counter>(c)));
+    }
+    fprintf(csv, "\n");
+
+    csv_header = true;
+}
+
+/**
+* @brief CloseCSV:  finish the CSV file
+*
+* @param (void)
+*/
+void Profiler::CloseCSV()
+{
+    if (csv)
+        fclose(csv);
+
+    csv = nullptr;
+}
+
+/**
+* @brief DrawOverlay:   draw the stage statistics and the pipeline counters
+*                       on the top left of the framebuffer
+*
+* @param (void)
+*/
+void Profiler::DrawOverlay()
+{
+    const int x = 8, y = 8;
+    const int lines = StageCount + 1 + COUNTERS;
+
+    //The hardware counters go to the right of the times
+    bool perf = PerfCounters::IsOpen();
+    int  columns = perf ? 60 : 32;
+
+    FillRect(x - 4, y - 4, columns * CHAR_WIDTH + 8, lines * LINE_HEIGHT + 4, 32, 32, 32);
+
+    char line[96];
+    int  length = snprintf(line, sizeof(line), "%-14s %5s %5s %5s", "ms", "min", "avg", "p99");
+    if (perf)
+        snprintf(line + length, sizeof(line) - length, " %5s %6s %6s %6s", "ipc", "l1/px", "llc/px", "br/px");
+    DrawText(x, y, line, 255, 255, 0);
+
+    for (int i = 0; i < StageCount; i++)
+    {
+        float min, avg, p99;
+        GetStats(static_cast<Stage>(i), min, avg, p99);
+
+        length = snprintf(line, sizeof(line), "%-14s %5.2f %5.2f %5.2f", NAMES[i], min, avg, p99);
+
+        float ipc, l1d, llc, branch;
+        if (GetCounterStats(static_cast<Stage>(i), ipc, l1d, llc, branch))
+            snprintf(line + length, sizeof(line) - length, " %5.2f %6.3f %6.3f %6.3f", ipc, l1d, llc, branch);
+
+        DrawText(x, y + (i + 1) * LINE_HEIGHT, line, 255, 255, 255);
+    }
+
+    //Counters of the frame being drawn
+    unsigned long long counters[COUNTERS];
+    GetCounters(counters);
+    for (int i = 0; i < COUNTERS; i++)
+    {
+        snprintf(line, sizeof(line), "%-15s %16llu", COUNTER_NAMES[i], counters[i]);
+        DrawText(x, y + (StageCount + 1 + i) * LINE_HEIGHT, line, 128, 255, 128);
+    }
+}
+
+#endif
@@ -0,0 +1,116 @@
+/****************************************************************************************/
+/*!
+\file   Profiler.h
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+Per-stage frame profiler. Every stage of the frame is timed with a scoped timer,
+the last frames are kept to compute the min/avg/p99 of each stage, and the times
+can be drawn on top of the frame or exported to a CSV file. When the hardware
+counters are open, the IPC and the misses per pixel of every stage are kept too.
+The profiler also counts every heap allocation, to check that a frame makes none.
+
+The profiler only exists when CS250_PROFILE is defined, otherwise the PROFILE_*
+macros expand to nothing and the instrumentation has no cost at all.
+Functions include:	Reset, BeginFrame, EndFrame, Add, AddCounters, GetStats,
+					GetCounterStats, GetName, GetFrameAllocations, OpenCSV, CloseCSV,
+					DrawOverlay
+
+*/
+/****************************************************************************************/
+
+#pragma once
+
+#include "Trace.h"          //Timeline of the scopes
+#include "PerfCounters.h"   //Hardware counters of the stages
+
+#ifdef CS250_PROFILE
+
+#include <chrono>
+
+class Profiler
+{
+  public:
+    //Stages of the frame, in pipeline order
+    enum Stage
+    {
+        input, model_to_world, camera, frustum, vertex, occlusion, sort, prepass, raster, shade,
+        clear, convert, upload, display,
+        frame,      //Whole frame, from BeginFrame to EndFrame
+        StageCount
+    };
+
+    static void Reset();
+    static void BeginFrame();
+    static void EndFrame();
+    static void Add(Stage stage, double ms);
+    static void AddCounters(Stage stage, const unsigned long long start[PerfCounters::CounterCount]);
+
+    static void         GetStats(Stage stage, float & min, float & avg, float & p99);
+    static bool         GetCounterStats(Stage stage, float & ipc, float & l1d_per_pixel,
+                                        float & llc_per_pixel, float & branch_per_pixel);
+    static const char * GetName(Stage stage);
+
+    static unsigned long long GetFrameAllocations();
+
+    static bool OpenCSV(const char * filename);
+    static void CloseCSV();
+
+    static void DrawOverlay();
+
+    //Adds the time from its construction to its destruction to a stage,
+    //and to the timeline when tracing and to the counters when they are open
+    class Scope
+    {
+      public:
+        Scope(Stage s) : stage(s)
+        {
+            if (PerfCounters::IsOpen())
+                PerfCounters::Read(counters);
+
+            start = std::chrono::high_resolution_clock::now();
+        }
+        ~Scope()
+        {
+            std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+
+            if (PerfCounters::IsOpen())
+                AddCounters(stage, counters);
+
+            std::chrono::duration<double, std::milli> time = end - start;
+            Add(stage, time.count());
+
+            if (Trace::IsActive())
+                Trace::Record(GetName(stage), start, end);
+        }
+
+      private:
+        Stage                                          stage;
+        std::chrono::high_resolution_clock::time_point start;
+        unsigned long long                             counters[PerfCounters::CounterCount];
+    };
+
+  private:
+    static void WriteCSVHeader();
+};
+
+#define PROFILE_CONCAT_(a, b)   a##b
+#define PROFILE_CONCAT(a, b)    PROFILE_CONCAT_(a, b)
+
+#define PROFILE_SCOPE(stage)    Profiler::Scope PROFILE_CONCAT(profile_scope_, __LINE__)(Profiler::stage)
+#define PROFILE_BEGIN_FRAME()   Profiler::BeginFrame()
+#define PROFILE_END_FRAME()     Profiler::EndFrame()
+#define PROFILE_DRAW_OVERLAY()  Profiler::DrawOverlay()
+
+#else
+
+#define PROFILE_SCOPE(stage)    ((void)0)
+#define PROFILE_BEGIN_FRAME()   ((void)0)
+#define PROFILE_END_FRAME()     ((void)0)
+#define PROFILE_DRAW_OVERLAY()  ((void)0)
+
+#endif
@@ -1,10 +1,34 @@
 
 #include "Rasterizer.h"
 #include "FrameBuffer.h"
+#include <cstdlib>
 
 namespace Rasterizer
 {
 
+thread_local Stats stats = {};
+
+void ResetStats()
+{
+    stats = Stats();
+}
+
+// Add the counters of another thread to the ones of this thread
+void AddStats(const Stats & other)
+{
+    stats.triangles_submitted  += other.triangles_submitted;
+    stats.triangles_culled     += other.triangles_culled;
+    stats.triangles_occluded   += other.triangles_occluded;
+    stats.triangles_simplified += other.triangles_simplified;
+    stats.triangles_clipped    += other.triangles_clipped;
+    stats.triangles_rasterized += other.triangles_rasterized;
+    stats.pixels_tested        += other.pixels_tested;
+    stats.pixels_passed        += other.pixels_passed;
+    stats.lines_stepped        += other.lines_stepped;
+    stats.pixels_shaded        += other.pixels_shaded;
+    stats.prepass_tested       += other.prepass_tested;
+}
+
 int Round(float f)
 {
     int i = static_cast<int>(f + 0.5f);
@@ -54,7 +78,11 @@ void DrawMidpointLine(const Vertex & v0, const Vertex & v1)
     float b = v0.color.b;
     float z = v0.position.z;
 
-    FrameBuffer::SetPixel(x, y, z, static_cast<unsigned char>(r * 255.99), static_cast<unsigned char>(g * 255.99), static_cast<unsigned char>(b * 255.99));
+    unsigned long long passed = 0;
+    stats.lines_stepped += 1 + (dx > dy ? dx : dy);
+    stats.pixels_tested += 1 + (dx > dy ? dx : dy);
+
+    passed += FrameBuffer::SetPixel(x, y, z, static_cast<unsigned char>(r * 255.99), static_cast<unsigned char>(g * 255.99), static_cast<unsigned char>(b * 255.99));
 
     if (abs(dy) > abs(dx)) // |m|>1
     {
@@ -75,7 +103,7 @@ void DrawMidpointLine(const Vertex & v0, const Vertex & v1)
             else
                 dstart += dn;
 
-            FrameBuffer::SetPixel(x, y, z, static_cast<unsigned char>(r * 255.99), static_cast<unsigned char>(g * 255.99), static_cast<unsigned char>(b * 255.99));
+            passed += FrameBuffer::SetPixel(x, y, z, static_cast<unsigned char>(r * 255.99), static_cast<unsigned char>(g * 255.99), static_cast<unsigned char>(b * 255.99));
 
             r += rInc;
             g += gInc;
@@ -102,7 +130,7 @@ void DrawMidpointLine(const Vertex & v0, const Vertex & v1)
             else
                 dstart += de;
 
-            FrameBuffer::SetPixel(x, y, z, static_cast<unsigned char>(r * 255.99), static_cast<unsigned char>(g * 255.99), static_cast<unsigned char>(b * 255.99));
+            passed += FrameBuffer::SetPixel(x, y, z, static_cast<unsigned char>(r * 255.99), static_cast<unsigned char>(g * 255.99), static_cast<unsigned char>(b * 255.99));
 
             r += rInc;
             g += gInc;
@@ -110,9 +138,23 @@ void DrawMidpointLine(const Vertex & v0, const Vertex & v1)
             z += zInc;
         }
     }
+
+    stats.pixels_passed += passed;
 }
 
-void DrawTriangleSolid(const Vertex & v0, const Vertex & v1, const Vertex & v2)
+// What FillTriangle writes to every pixel
+enum Fill
+{
+    fill_color,     // depth and color where the depth test passes
+    fill_id,        // depth and id of the triangle, for the visibility buffer
+    fill_depth,     // only the depth, for the prepass
+    fill_equal      // only the color, where the depth is the one of the prepass
+};
+
+// Fill a triangle with its colors, or with only some of them. Every fill interpolates
+// the depth the same way, so the prepass and the color pass get the exact same values
+template <Fill Pass>
+void FillTriangle(const Vertex & v0, const Vertex & v1, const Vertex & v2, unsigned id)
 {
     // Select TOP, MIDDLE and BOTTOM vertices
     // --------------------------------------
@@ -201,6 +243,10 @@ void DrawTriangleSolid(const Vertex & v0, const Vertex & v1, const Vertex & v2)
     int   x;
     int   xMax = Ceiling(xR) - 1;
 
+    // Row the left and right edges start at, and their x there
+    int   yLeft  = y, yRight = y;
+    float xLeft  = xL, xRight = xR;
+
     // Initial Color Interpolation (Plane Equation Parameters)
     // RED
     float v1R[3] = {middle->position.x - top->position.x, middle->position.y - top->position.y, static_cast<float>(middle->color.r - top->color.r)};
@@ -229,46 +275,77 @@ void DrawTriangleSolid(const Vertex & v0, const Vertex & v1, const Vertex & v2)
     float zIncX = -nZ[0] / nZ[2];
     float zIncY = -nZ[1] / nZ[2];
 
-    float rL = top->color.r;
-    float gL = top->color.g;
-    float bL = top->color.b;
-    float zL = top->position.z;
+    // Colors and depth at the left edge where it starts
+    float rLeft = top->color.r;
+    float gLeft = top->color.g;
+    float bLeft = top->color.b;
+    float zLeft = top->position.z;
 
+    float rL, gL, bL, zL;
     float r, g, b, z;
 
+    unsigned long long tested = 0, passed = 0;
+
+    // Only the rows and pixels inside the clip rectangle are visited. Every value is the
+    // start of its edge or row plus a multiple of the increment instead of a sum of
+    // increments, so every pixel gets the same values with any clip rectangle as without one
+    int clipLeft, clipTop, clipRight, clipBottom;
+    FrameBuffer::GetClipRect(clipLeft, clipTop, clipRight, clipBottom);
+    if (yMax >= clipBottom)
+        yMax = clipBottom - 1;
+    if (y < clipTop)
+        y = clipTop;
+
     // Start the loop, from the y_top to y_middle
     while (y <= yMax)
     {
+        float left  = static_cast<float>(y - yLeft);
+        float right = static_cast<float>(y - yRight);
+
+        xL = xLeft + left * xIncLeft;
+        xR = xRight + right * xIncRight;
+
+        rL = rLeft + left * (rIncY + rIncX * xIncLeft);
+        gL = gLeft + left * (gIncY + gIncX * xIncLeft);
+        bL = bLeft + left * (bIncY + bIncX * xIncLeft);
+        zL = zLeft + left * (zIncY + zIncX * xIncLeft);
+
         // Loop along the scanline, from left to right
-        x    = Ceiling(xL);
+        int first = Ceiling(xL);
+        x    = first;
         xMax = Ceiling(xR) - 1;
 
-        r = rL;
-        g = gL;
-        b = bL;
-        z = zL;
+        // Nothing is written outside of the clip rectangle
+        if (xMax >= clipRight)
+            xMax = clipRight - 1;
+        if (x < clipLeft)
+            x = clipLeft;
 
+        if (xMax >= x)
+            tested += xMax - x + 1;
 
         while (x <= xMax)
         {
-            FrameBuffer::SetPixel(x, y, z, static_cast<unsigned char>(r * 255.99), static_cast<unsigned char>(g * 255.99), static_cast<unsigned char>(b * 255.99));
+            float step = static_cast<float>(x - first);
+
+            r = rL + step * rIncX;
+            g = gL + step * gIncX;
+            b = bL + step * bIncX;
+            z = zL + step * zIncX;
+
+            if (Pass == fill_id)
+                passed += FrameBuffer::SetId(x, y, z, id);
+            else if (Pass == fill_depth)
+                passed += FrameBuffer::SetDepth(x, y, z);
+            else if (Pass == fill_equal)
+                passed += FrameBuffer::SetPixelIfEqual(x, y, z, static_cast<unsigned char>(r * 255.99), static_cast<unsigned char>(g * 255.99), static_cast<unsigned char>(b * 255.99));
+            else
+                passed += FrameBuffer::SetPixel(x, y, z, static_cast<unsigned char>(r * 255.99), static_cast<unsigned char>(g * 255.99), static_cast<unsigned char>(b * 255.99));
 
             ++x;
-
-            r += rIncX;
-            g += gIncX;
-            b += bIncX;
-            z += zIncX;
         }
 
-        xL += xIncLeft;
-        xR += xIncRight;
         ++y;
-
-        rL += rIncY + rIncX * xIncLeft;
-        gL += gIncY + gIncX * xIncLeft;
-        bL += bIncY + bIncX * xIncLeft;
-        zL += zIncY + zIncX * xIncLeft;
     }
 
     // MIDDLE to BOTTOM
@@ -279,55 +356,149 @@ void DrawTriangleSolid(const Vertex & v0, const Vertex & v1, const Vertex & v2)
     y    = Ceiling(middle->position.y);
     yMax = Ceiling(bottom->position.y) - 1;
 
+    // The edge that ends at the middle is replaced, the other one goes on
     if (middle_is_left)
     {
         xIncLeft = (bottom->position.x - left->position.x) / (bottom->position.y - left->position.y);
-        xL       = left->position.x;
+        xLeft    = left->position.x;
+        yLeft    = y;
 
-        rL = middle->color.r;
-        gL = middle->color.g;
-        bL = middle->color.b;
-        zL = middle->position.z;
+        rLeft = middle->color.r;
+        gLeft = middle->color.g;
+        bLeft = middle->color.b;
+        zLeft = middle->position.z;
     }
     else
     {
         xIncRight = (bottom->position.x - right->position.x) / (bottom->position.y - right->position.y);
-        xR        = right->position.x;
+        xRight    = right->position.x;
+        yRight    = y;
     }
 
+    if (yMax >= clipBottom)
+        yMax = clipBottom - 1;
+    if (y < clipTop)
+        y = clipTop;
+
     // Start the loop, from the y_top to y_middle
     while (y <= yMax)
     {
-        x    = Ceiling(xL);
-        xMax = Ceiling(xR) - 1;
+        float left  = static_cast<float>(y - yLeft);
+        float right = static_cast<float>(y - yRight);
+
+        xL = xLeft + left * xIncLeft;
+        xR = xRight + right * xIncRight;
 
-        r = rL;
-        g = gL;
-        b = bL;
-        z = zL;
+        rL = rLeft + left * (rIncY + rIncX * xIncLeft);
+        gL = gLeft + left * (gIncY + gIncX * xIncLeft);
+        bL = bLeft + left * (bIncY + bIncX * xIncLeft);
+        zL = zLeft + left * (zIncY + zIncX * xIncLeft);
 
         // Loop along the scanline, from left to right
+        int first = Ceiling(xL);
+        x    = first;
+        xMax = Ceiling(xR) - 1;
+
+        // Nothing is written outside of the clip rectangle
+        if (xMax >= clipRight)
+            xMax = clipRight - 1;
+        if (x < clipLeft)
+            x = clipLeft;
+
+        if (xMax >= x)
+            tested += xMax - x + 1;
+
         while (x <= xMax)
         {
-            FrameBuffer::SetPixel(x, y, z, static_cast<unsigned char>(r * 255.99), static_cast<unsigned char>(g * 255.99), static_cast<unsigned char>(b * 255.99));
+            float step = static_cast<float>(x - first);
+
+            r = rL + step * rIncX;
+            g = gL + step * gIncX;
+            b = bL + step * bIncX;
+            z = zL + step * zIncX;
+
+            if (Pass == fill_id)
+                passed += FrameBuffer::SetId(x, y, z, id);
+            else if (Pass == fill_depth)
+                passed += FrameBuffer::SetDepth(x, y, z);
+            else if (Pass == fill_equal)
+                passed += FrameBuffer::SetPixelIfEqual(x, y, z, static_cast<unsigned char>(r * 255.99), static_cast<unsigned char>(g * 255.99), static_cast<unsigned char>(b * 255.99));
+            else
+                passed += FrameBuffer::SetPixel(x, y, z, static_cast<unsigned char>(r * 255.99), static_cast<unsigned char>(g * 255.99), static_cast<unsigned char>(b * 255.99));
 
             ++x;
-
-            r += rIncX;
-            g += gIncX;
-            b += bIncX;
-            z += zIncX;
         }
 
-        xL += xIncLeft;
-        xR += xIncRight;
         ++y;
+    }
 
-        rL += rIncY + rIncX * xIncLeft;
-        gL += gIncY + gIncX * xIncLeft;
-        bL += bIncY + bIncX * xIncLeft;
-        zL += zIncY + zIncX * xIncLeft;
+    // The prepass is counted apart, the triangle is counted by its color pass
+    if (Pass == fill_depth)
+    {
+        stats.prepass_tested += tested;
+        return;
     }
+
+    stats.triangles_rasterized++;
+    stats.pixels_tested += tested;
+    stats.pixels_passed += passed;
+    if (Pass != fill_id)
+        stats.pixels_shaded += passed;
+}
+
+void DrawTriangleSolid(const Vertex & v0, const Vertex & v1, const Vertex & v2)
+{
+    FillTriangle<fill_color>(v0, v1, v2, 0);
+}
+
+// Only the depth and the id of the triangle, the colors come later from InterpolateColor
+void DrawTriangleVisibility(const Vertex & v0, const Vertex & v1, const Vertex & v2, unsigned id)
+{
+    FillTriangle<fill_id>(v0, v1, v2, id);
+}
+
+// Only the depth, the colors are not interpolated at all
+void DrawTriangleDepth(const Vertex & v0, const Vertex & v1, const Vertex & v2)
+{
+    FillTriangle<fill_depth>(v0, v1, v2, 0);
+}
+
+// Only the colors of the pixels the triangle won in the prepass
+void DrawTriangleEqual(const Vertex & v0, const Vertex & v1, const Vertex & v2)
+{
+    FillTriangle<fill_equal>(v0, v1, v2, 0);
+}
+
+// Color of a triangle at a pixel, from the plane of every color channel
+bool CoversNoRow(float top, float bottom)
+{
+    // FillTriangle fills the rows from the ceiling of the top to the one before the ceiling of the bottom
+    return Ceiling(top) >= Ceiling(bottom);
+}
+
+Point4 InterpolateColor(const Vertex & v0, const Vertex & v1, const Vertex & v2, float x, float y)
+{
+    float x0 = v0.position.x, y0 = v0.position.y;
+    float x1 = v1.position.x, y1 = v1.position.y;
+    float x2 = v2.position.x, y2 = v2.position.y;
+
+    // Weights of the vertices, the same planes DrawTriangleSolid steps along
+    float area = (y1 - y2) * (x0 - x2) + (x2 - x1) * (y0 - y2);
+    float w0   = ((y1 - y2) * (x - x2) + (x2 - x1) * (y - y2)) / area;
+    float w1   = ((y2 - y0) * (x - x2) + (x0 - x2) * (y - y2)) / area;
+    float w2   = 1.f - w0 - w1;
+
+    Point4 color;
+    color.r = v0.color.r * w0 + v1.color.r * w1 + v2.color.r * w2;
+    color.g = v0.color.g * w0 + v1.color.g * w1 + v2.color.g * w2;
+    color.b = v0.color.b * w0 + v1.color.b * w1 + v2.color.b * w2;
+
+    // The pixel centers on the edges are a bit outside of the triangle
+    color.r = color.r < 0.f ? 0.f : (color.r > 1.f ? 1.f : color.r);
+    color.g = color.g < 0.f ? 0.f : (color.g > 1.f ? 1.f : color.g);
+    color.b = color.b < 0.f ? 0.f : (color.b > 1.f ? 1.f : color.b);
+
+    return color;
 }
 
 } // namespace Rasterizer
@@ -1,3 +1,4 @@
+#pragma once
 
 #include "Math/Point4.h"
 
@@ -10,8 +11,43 @@ struct Vertex
     Point4 color;
 };
 
+// Pipeline counters of the current frame, of the calling thread
+struct Stats
+{
+    unsigned long long triangles_submitted;  // reached the vertex stage
+    unsigned long long triangles_culled;     // rejected by the near plane, or in a cluster turned away from the camera
+    unsigned long long triangles_occluded;   // of objects hidden behind the occluders or outside of the view
+    unsigned long long triangles_simplified; // left out by a simpler level of detail, or of objects too small to see
+    unsigned long long triangles_clipped;    // partially outside the screen, cut per pixel
+    unsigned long long triangles_rasterized; // filled by DrawTriangleSolid
+    unsigned long long pixels_tested;        // generated by the rasterizer
+    unsigned long long pixels_passed;        // passed the depth test and were written
+    unsigned long long lines_stepped;        // pixels stepped along the midpoint lines
+    unsigned long long pixels_shaded;        // given their color by a triangle, or by the visibility buffer
+    unsigned long long prepass_tested;       // generated by the depth prepass
+};
+
+extern thread_local Stats stats;
+
+void ResetStats();
+void AddStats(const Stats & other);
+
 void DrawMidpointLine(const Vertex & v1, const Vertex & v2);
 
 void DrawTriangleSolid(const Vertex & p0, const Vertex & p1, const Vertex & p2);
 
+// Visibility buffer: the first pass only writes the depth and the id of the triangle,
+// then every visible pixel gets its color once
+void DrawTriangleVisibility(const Vertex & p0, const Vertex & p1, const Vertex & p2, unsigned id);
+// Depth prepass: the first pass only writes the depth, then the colors are only written
+// where a triangle has the depth the prepass left
+void DrawTriangleDepth(const Vertex & p0, const Vertex & p1, const Vertex & p2);
+void DrawTriangleEqual(const Vertex & p0, const Vertex & p1, const Vertex & p2);
+
+// Whether the triangle fills write nothing for a triangle from the top to the bottom y,
+// because no row of pixels is between them
+bool CoversNoRow(float top, float bottom);
+
+Point4 InterpolateColor(const Vertex & p0, const Vertex & p1, const Vertex & p2, float x, float y);
+
 } // namespace Rasterize
\ No newline at end of file
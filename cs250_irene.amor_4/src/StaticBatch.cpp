@@ -0,0 +1,46 @@
+/****************************************************************************************/
+/*!
+\file   StaticBatch.cpp
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+This file contains the implementation of the world vertices of the objects
+that never move.
+Functions include:	Build
+
+*/
+/****************************************************************************************/
+
+#include "StaticBatch.h"    //Header file
+
+namespace StaticBatch
+{
+
+/**
+* @brief Build:     transform the mesh of some objects to the world, in the order of the list
+*
+* @param batch:     batch to build, anything in it is replaced
+* @param mesh:      vertices of the mesh of every object
+* @param m2w:       model to world with scale of every object of the scene
+* @param objects:   objects that never move
+*/
+void Build(Batch & batch, const std::vector<Point4> & mesh, const std::vector<Matrix4> & m2w,
+           const std::vector<int> & objects)
+{
+    batch.first_vertex.assign(m2w.size(), -1);
+    batch.vertices.resize(objects.size() * mesh.size());
+
+    Point4 * vertex = batch.vertices.data();
+    for (int obj : objects)
+    {
+        batch.first_vertex[obj] = static_cast<int>(vertex - batch.vertices.data());
+        for (const Point4 & position : mesh)
+            *vertex++ = m2w[obj] * position;
+    }
+}
+
+} // namespace StaticBatch
@@ -0,0 +1,40 @@
+/****************************************************************************************/
+/*!
+\file   StaticBatch.h
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+World vertices of the objects that never move. The mesh of every one of them
+is transformed to the world once, one object after the other in a single
+buffer, so every frame they only need the camera and the perspective of each
+view instead of a matrix of their own. All the objects share the faces of the
+mesh, the vertices of an object start at its first vertex.
+Functions include:	Build
+
+*/
+/****************************************************************************************/
+
+#pragma once
+
+#include "Math/Matrix4.h"
+#include "Math/Point4.h"
+#include <vector>
+
+namespace StaticBatch
+{
+
+struct Batch
+{
+    std::vector<int>    first_vertex;   // of every object of the scene, -1 for the ones that move
+    std::vector<Point4> vertices;       // world vertices of the objects that never move
+};
+
+// Transform the mesh of some objects to the world, anything in the batch is replaced
+void Build(Batch & batch, const std::vector<Point4> & mesh, const std::vector<Matrix4> & m2w,
+           const std::vector<int> & objects);
+
+} // namespace StaticBatch
@@ -0,0 +1,93 @@
+/****************************************************************************************/
+/*!
+\file   SwapChain.cpp
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+This file contains the implementation of the swap chain.
+Functions include:	SwapChain, ~SwapChain, BeginRender, EndRender, BeginPresent,
+					EndPresent, Stop
+
+*/
+/****************************************************************************************/
+
+#include "SwapChain.h"  //Header file
+
+/**
+* @brief SwapChain: allocate the buffers
+*
+* @param width:     width of the frames
+* @param height:    height of the frames
+* @param count:     buffers in flight, from 1 to MAX_BUFFERS
+*/
+SwapChain::SwapChain(int width, int height, int count)
+    : queue(count < 1 ? 1 : (count > MAX_BUFFERS ? MAX_BUFFERS : count))
+{
+    for (int i = 0; i < queue.GetSlots(); i++)
+        FrameBuffer::Allocate(buffers[i], width, height);
+}
+
+/**
+* @brief ~SwapChain:    free the buffers, neither thread can be using them
+*/
+SwapChain::~SwapChain()
+{
+    for (int i = 0; i < queue.GetSlots(); i++)
+        FrameBuffer::Release(buffers[i]);
+}
+
+/**
+* @brief BeginRender:   wait until a buffer is not waiting to be presented
+*
+* @return               buffer to render the next frame to, nullptr once stopped
+*/
+FrameBuffer::Buffer * SwapChain::BeginRender()
+{
+    int slot = queue.BeginProduce();
+    return slot >= 0 ? &buffers[slot] : nullptr;
+}
+
+/**
+* @brief EndRender: hand the rendered buffer to the present thread
+*
+* @param (void)
+*/
+void SwapChain::EndRender()
+{
+    queue.EndProduce();
+}
+
+/**
+* @brief BeginPresent:  wait until a frame is rendered
+*
+* @return               buffer to present, nullptr when there are no more frames
+*/
+FrameBuffer::Buffer * SwapChain::BeginPresent()
+{
+    int slot = queue.BeginConsume();
+    return slot >= 0 ? &buffers[slot] : nullptr;
+}
+
+/**
+* @brief EndPresent:    the presented buffer can be rendered to again
+*
+* @param (void)
+*/
+void SwapChain::EndPresent()
+{
+    queue.EndConsume();
+}
+
+/**
+* @brief Stop:  let the present thread finish once it presents the frames rendered
+*
+* @param (void)
+*/
+void SwapChain::Stop()
+{
+    queue.Stop();
+}
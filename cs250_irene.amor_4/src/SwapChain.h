@@ -0,0 +1,55 @@
+/****************************************************************************************/
+/*!
+\file   SwapChain.h
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+Ring of framebuffers shared by the thread that renders and the thread that
+presents. The render thread draws frame N+1 into a free buffer while the present
+thread uploads and displays frame N, and the buffers are handed over by a
+FrameQueue. A thread that has to wait for the other one sleeps instead of
+taking a core.
+
+The number of buffers sets how far rendering can get ahead of the screen:
+with 1 buffer the next frame waits until the last one is converted, 2 buffers
+overlap the whole present with one frame of latency, 3 buffers can queue one more.
+Functions include:	SwapChain, ~SwapChain, BeginRender, EndRender, BeginPresent,
+					EndPresent, Stop
+
+*/
+/****************************************************************************************/
+
+#pragma once
+
+#include "FrameBuffer.h"
+#include "FrameQueue.h"
+
+class SwapChain
+{
+  public:
+    static const int MAX_BUFFERS = 4;
+
+    SwapChain(int width, int height, int count);
+    ~SwapChain();
+
+    // Render thread: buffer to draw the next frame to, waits until one is free. nullptr once stopped
+    FrameBuffer::Buffer * BeginRender();
+    void                  EndRender();
+
+    // Present thread: oldest frame not presented yet, nullptr once stopped and every frame is presented
+    FrameBuffer::Buffer * BeginPresent();
+    void                  EndPresent();
+
+    // No more frames will be rendered
+    void Stop();
+
+    int GetCount() const { return queue.GetSlots(); }
+
+  private:
+    FrameBuffer::Buffer buffers[MAX_BUFFERS];
+    FrameQueue          queue;          //Rendered buffers waiting to be presented
+};
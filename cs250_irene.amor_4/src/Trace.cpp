@@ -0,0 +1,210 @@
+/****************************************************************************************/
+/*!
+\file   Trace.cpp
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+This file contains the implementation of the timeline tracer.
+Functions include:	Start, Stop, Record, SetThreadName, GetBuffer
+
+*/
+/****************************************************************************************/
+
+#include "Trace.h"          //Header file
+
+#ifdef CS250_PROFILE
+
+#include "Platform.h"       //fopen_s outside of MSVC
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+std::atomic<bool> Trace::active(false);
+
+namespace
+{
+    //Complete event, times in nanoseconds from the start of the trace
+    struct Event
+    {
+        const char * name;
+        long long    start;
+        long long    duration;
+    };
+
+    //Events are stored in fixed chunks so that recorded events never move
+    const size_t CHUNK_EVENTS = 4096;
+
+    //Events of one thread, only written by that thread
+    struct ThreadBuffer
+    {
+        unsigned                              id;
+        std::string                           name;
+        std::vector<std::unique_ptr<Event[]>> chunks;
+        size_t                                count = 0;
+    };
+
+    //Every thread that recorded something, the lock is only taken the first time
+    std::mutex                                 registry_lock;
+    std::vector<std::unique_ptr<ThreadBuffer>> registry;
+    thread_local ThreadBuffer *                local_buffer = nullptr;
+
+    Trace::clock::time_point origin;
+    std::string              filename;
+
+
+    /**
+    * @brief GetBuffer: buffer of the calling thread, created the first time
+    */
+    ThreadBuffer & GetBuffer()
+    {
+        if (!local_buffer)
+        {
+            std::lock_guard<std::mutex> lock(registry_lock);
+
+            registry.emplace_back(new ThreadBuffer);
+            local_buffer       = registry.back().get();
+            local_buffer->id   = static_cast<unsigned>(registry.size());
+            local_buffer->name = "thread " + std::to_string(local_buffer->id);
+        }
+
+        return *local_buffer;
+    }
+
+    /**
+    * @brief WriteString:   write a string to the JSON, escaping what needs it
+    */
+    void WriteString(FILE * out, const char * text)
+    {
+        fputc('"', out);
+        for (; *text; text++)
+        {
+            if (*text == '"' || *text == '\\')
+                fputc('\\', out);
+            fputc(*text, out);
+        }
+        fputc('"', out);
+    }
+}
+
+
+/**
+* @brief Start:     start recording the timed scopes of every thread
+*
+* @param file:      JSON file written by Stop
+* @return           whether the tracer started
+*/
+bool Trace::Start(const char * file)
+{
+    if (!file)
+        return false;
+
+    {
+        std::lock_guard<std::mutex> lock(registry_lock);
+        for (std::unique_ptr<ThreadBuffer> & buffer : registry)
+            buffer->count = 0;
+    }
+
+    //The thread that starts the trace is the main one
+    ThreadBuffer & buffer = GetBuffer();
+    if (buffer.id == 1)
+        buffer.name = "main";
+
+    filename = file;
+    origin   = clock::now();
+    active.store(true);
+
+    return true;
+}
+
+/**
+* @brief Stop:      stop recording and write the trace, the other threads
+*                   must not be recording anymore
+*
+* @param (void)
+*/
+void Trace::Stop()
+{
+    if (!active.exchange(false))
+        return;
+
+    FILE * out = nullptr;
+    fopen_s(&out, filename.c_str(), "w");
+    if (!out)
+    {
+        fprintf(stderr, "Could not write trace %s\n", filename.c_str());
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(registry_lock);
+
+    fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    bool first = true;
+    for (const std::unique_ptr<ThreadBuffer> & buffer : registry)
+    {
+        //Name of the thread
+        fprintf(out, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+                first ? "" : ",\n", buffer->id);
+        WriteString(out, buffer->name.c_str());
+        fprintf(out, "}}");
+        first = false;
+
+        //Events, in microseconds
+        for (size_t i = 0; i < buffer->count; i++)
+        {
+            const Event & event = buffer->chunks[i / CHUNK_EVENTS][i % CHUNK_EVENTS];
+
+            fprintf(out, ",\n{\"name\":");
+            WriteString(out, event.name);
+            fprintf(out, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                    buffer->id, event.start / 1000.0, event.duration / 1000.0);
+        }
+    }
+
+    fprintf(out, "\n]}\n");
+    fclose(out);
+}
+
+/**
+* @brief Record:    add an event to the buffer of the calling thread
+*
+* @param name:      name of the event
+* @param start:     when it started
+* @param end:       when it ended
+*/
+void Trace::Record(const char * name, clock::time_point start, clock::time_point end)
+{
+    if (!IsActive())
+        return;
+
+    ThreadBuffer & buffer = GetBuffer();
+
+    //New chunk when the last one is full
+    if (buffer.count == buffer.chunks.size() * CHUNK_EVENTS)
+        buffer.chunks.emplace_back(new Event[CHUNK_EVENTS]);
+
+    Event & event   = buffer.chunks[buffer.count / CHUNK_EVENTS][buffer.count % CHUNK_EVENTS];
+    event.name      = name;
+    event.start     = std::chrono::duration_cast<std::chrono::nanoseconds>(start - origin).count();
+    event.duration  = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+    buffer.count++;
+}
+
+/**
+* @brief SetThreadName: name of the calling thread in the trace
+*
+* @param name:          name shown on the timeline
+*/
+void Trace::SetThreadName(const char * name)
+{
+    GetBuffer().name = name;
+}
+
+#endif
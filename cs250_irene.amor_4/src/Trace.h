@@ -0,0 +1,76 @@
+/****************************************************************************************/
+/*!
+\file   Trace.h
+\author Irene Amor Mendez
+\par    email: irene.amor@digipen.edu
+\par    DigiPen login: irene.amor
+\par    Course: CS250
+\date   19/10/2026
+\brief
+
+Timeline tracer. Every timed scope is recorded as a begin/end event with the
+thread that ran it, and the events are saved as Chrome trace_event JSON that
+can be opened in about:tracing or Perfetto to see the frame pacing, the idle
+time of the threads and where they wait for each other.
+
+Each thread writes only to its own buffer, so recording takes no lock. The
+buffers are written to the file by Stop, once the other threads are idle.
+
+Like the profiler, the tracer only exists when CS250_PROFILE is defined.
+Functions include:	Start, Stop, IsActive, Record, SetThreadName
+
+*/
+/****************************************************************************************/
+
+#pragma once
+
+#ifdef CS250_PROFILE
+
+#include <atomic>
+#include <chrono>
+
+class Trace
+{
+  public:
+    typedef std::chrono::high_resolution_clock clock;
+
+    static bool Start(const char * filename);
+    static void Stop();
+    static bool IsActive() { return active.load(std::memory_order_relaxed); }
+
+    // The name is not copied, it has to be a string literal or live until Stop
+    static void Record(const char * name, clock::time_point start, clock::time_point end);
+    static void SetThreadName(const char * name);
+
+    //Records the time from its construction to its destruction
+    class Scope
+    {
+      public:
+        Scope(const char * n) : name(n), start(clock::now()) {}
+        ~Scope()
+        {
+            if (IsActive())
+                Record(name, start, clock::now());
+        }
+
+      private:
+        const char *      name;
+        clock::time_point start;
+    };
+
+  private:
+    static std::atomic<bool> active;
+};
+
+#define TRACE_CONCAT_(a, b)     a##b
+#define TRACE_CONCAT(a, b)      TRACE_CONCAT_(a, b)
+
+#define TRACE_SCOPE(name)       Trace::Scope TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#define TRACE_THREAD_NAME(name) Trace::SetThreadName(name)
+
+#else
+
+#define TRACE_SCOPE(name)       ((void)0)
+#define TRACE_THREAD_NAME(name) ((void)0)
+
+#endif
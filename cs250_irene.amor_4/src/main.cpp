@@ -19,53 +19,414 @@ Hours spent on this assignment: ~20
 /****************************************************************************************/
 
 #include "AirplaneFunctions.h"
+#include "Headless.h"
+#include "Batch.h"
+#include "Benchmark.h"
+#include "Golden.h"
+#include "SwapChain.h"
+#include "Pipeline.h"
+#include "JobSystem.h"
+#include <thread>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
 
-int main()
+#ifndef CS250_HEADLESS
+#include <SFML/Graphics.hpp>
+#endif
+
+int main(int argc, char * argv[])
 {
     //Create a airplane
     Airplane airplane;
     airplane.Airplane_Initialize();
 
+    //Command line options
+    //  --headless <frames>     render without a window
+    //  --output <dir|->        where the headless frames are written
+    //  --batch <file>          render the scene from every camera pose of the file
+    //  --mode <depth|wireframe|solid|overdraw>
+    //  --camera <first|rooted|third>
+    //  --views <single|split|pip>
+    //  --tiles <size>          draw in tiles of size*size pixels (0 to draw without tiles, default)
+    //  --shading <forward|visibility|prepass>
+    //  --order <file|front>    draw the objects in file order (default) or the nearest ones first
+    //  --occlusion             skip the objects hidden behind the large objects near the camera
+    //  --bvh                   skip the objects outside of the views with a hierarchy of their boxes
+    //  --lod                   simpler meshes for the objects far away, skip the ones smaller than a pixel
+    //  --meshlets              skip the clusters of faces outside of the views or turned away from the camera
+    //  --static-batch          transform the objects that never move to the world once, only the camera every frame
+    //  --record <file>         save the key states of every frame
+    //  --replay <file>         use the recorded key states instead of the keyboard
+    //  --camera-path <file>    follow a scripted camera path
+    //  --bench <frames>        run the rasterizer benchmark, CSV results on stdout
+    //  --threads <count>       threads of the job system, 0 for one per core (default)
+    //  --pin-threads           keep every worker thread on its own core
+    //  --buffers <count>       framebuffers in flight in the window (1 to 4, default 2)
+    //  --serial                simulate each frame right before rendering it, on the same thread
+    //  --frame-rate <fps>      headless frames per simulated second (default 60, one per step)
+    //  --golden <dir>          compare the golden cases with the references in dir
+    //  --golden-update <dir>   write the references of the golden cases to dir
+    //  --tolerance <value>     largest channel difference of a matching golden pixel
+    //  --max-bad <pixels>      pixels per golden image allowed over the tolerance
+    //  --profile-csv <file>    export the stage times of every frame (CS250_PROFILE builds)
+    //  --trace <file>          save a Chrome trace of every timed scope (CS250_PROFILE builds)
+    //  --perf-counters         read the hardware counters of every stage (CS250_PROFILE builds, Linux)
+    int          headless_frames = -1;
+    int          bench_frames    = 0;
+    int          threads         = 0;
+    bool         pin_threads     = false;
+    const char * output          = nullptr;
+    const char * batch_poses     = nullptr;
+    bool         replaying       = false;
+    const char * record_file     = nullptr;
+    bool         golden          = false;
+    int          buffers         = 2;
+    bool         pipelined       = true;
+    double       frame_time      = Airplane::TICK;
+
+    Golden::Options golden_options;
+
+    //A wrong option or value stops the program instead of running something else
+    const char * option = nullptr;
+    auto bad_value = [&option](const char * value)
+    {
+        fprintf(stderr, "Unknown value of %s: %s\n", option, value);
+        return 1;
+    };
+    auto integer = [](const char * text, int & value)
+    {
+        char * end  = nullptr;
+        long number = strtol(text, &end, 10);
+        value = static_cast<int>(number);
+        return end != text && *end == '\0';
+    };
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool has_value = i + 1 < argc;
+        option = argv[i];
+
+        if (!strcmp(argv[i], "--headless") && has_value)
+        {
+            if (!integer(argv[++i], headless_frames) || headless_frames < 0)
+                return bad_value(argv[i]);
+        }
+        else if (!strcmp(argv[i], "--output") && has_value)
+            output = argv[++i];
+        else if (!strcmp(argv[i], "--mode") && has_value)
+        {
+            i++;
+            if (!strcmp(argv[i], "depth"))
+                airplane.SetDrawMode(Airplane::depth_buffer);
+            else if (!strcmp(argv[i], "wireframe"))
+                airplane.SetDrawMode(Airplane::wireframe);
+            else if (!strcmp(argv[i], "overdraw"))
+                airplane.SetDrawMode(Airplane::overdraw);
+            else if (!strcmp(argv[i], "solid"))
+                airplane.SetDrawMode(Airplane::solid);
+            else
+                return bad_value(argv[i]);
+        }
+        else if (!strcmp(argv[i], "--camera") && has_value)
+        {
+            i++;
+            if (!strcmp(argv[i], "first"))
+                airplane.SetCamera(Airplane::first);
+            else if (!strcmp(argv[i], "third"))
+                airplane.SetCamera(Airplane::third);
+            else if (!strcmp(argv[i], "rooted"))
+                airplane.SetCamera(Airplane::rooted);
+            else
+                return bad_value(argv[i]);
+        }
+        else if (!strcmp(argv[i], "--views") && has_value)
+        {
+            i++;
+            if (!strcmp(argv[i], "split"))
+                airplane.SetLayout(Airplane::split);
+            else if (!strcmp(argv[i], "pip"))
+                airplane.SetLayout(Airplane::picture_in_picture);
+            else if (!strcmp(argv[i], "single"))
+                airplane.SetLayout(Airplane::single);
+            else
+                return bad_value(argv[i]);
+        }
+        else if (!strcmp(argv[i], "--tiles") && has_value)
+        {
+            int size = 0;
+            if (!integer(argv[++i], size) || size < 0)
+                return bad_value(argv[i]);
+            airplane.SetTileSize(size);
+        }
+        else if (!strcmp(argv[i], "--shading") && has_value)
+        {
+            i++;
+            if (!strcmp(argv[i], "visibility"))
+                airplane.SetShading(Airplane::visibility);
+            else if (!strcmp(argv[i], "prepass"))
+                airplane.SetShading(Airplane::depth_prepass);
+            else if (!strcmp(argv[i], "forward"))
+                airplane.SetShading(Airplane::forward);
+            else
+                return bad_value(argv[i]);
+        }
+        else if (!strcmp(argv[i], "--order") && has_value)
+        {
+            i++;
+            if (!strcmp(argv[i], "front"))
+                airplane.SetDrawOrder(Airplane::front_to_back);
+            else if (!strcmp(argv[i], "file"))
+                airplane.SetDrawOrder(Airplane::file_order);
+            else
+                return bad_value(argv[i]);
+        }
+        else if (!strcmp(argv[i], "--occlusion"))
+            airplane.SetOcclusionCulling(true);
+        else if (!strcmp(argv[i], "--bvh"))
+            airplane.SetFrustumCulling(true);
+        else if (!strcmp(argv[i], "--lod"))
+            airplane.SetLevelOfDetail(true);
+        else if (!strcmp(argv[i], "--meshlets"))
+            airplane.SetMeshletCulling(true);
+        else if (!strcmp(argv[i], "--static-batch"))
+            airplane.SetStaticBatching(true);
+        else if (!strcmp(argv[i], "--batch") && has_value)
+            batch_poses = argv[++i];
+        else if (!strcmp(argv[i], "--bench") && has_value)
+        {
+            if (!integer(argv[++i], bench_frames) || bench_frames <= 0)
+                return bad_value(argv[i]);
+        }
+        else if (!strcmp(argv[i], "--threads") && has_value)
+        {
+            if (!integer(argv[++i], threads) || threads < 0)
+                return bad_value(argv[i]);
+        }
+        else if (!strcmp(argv[i], "--pin-threads"))
+            pin_threads = true;
+        else if ((!strcmp(argv[i], "--golden") || !strcmp(argv[i], "--golden-update")) && has_value)
+        {
+            golden                   = true;
+            golden_options.update    = !strcmp(argv[i], "--golden-update");
+            golden_options.directory = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--buffers") && has_value)
+        {
+            if (!integer(argv[++i], buffers) || buffers < 1)
+                return bad_value(argv[i]);
+        }
+        else if (!strcmp(argv[i], "--serial"))
+            pipelined = false;
+        else if (!strcmp(argv[i], "--frame-rate") && has_value)
+        {
+            char * end = nullptr;
+            double fps = strtod(argv[++i], &end);
+            if (end == argv[i] || *end != '\0' || !(fps > 0.0))
+                return bad_value(argv[i]);
+            frame_time = 1.0 / fps;
+        }
+        else if (!strcmp(argv[i], "--tolerance") && has_value)
+        {
+            if (!integer(argv[++i], golden_options.tolerance) || golden_options.tolerance < 0)
+                return bad_value(argv[i]);
+        }
+        else if (!strcmp(argv[i], "--max-bad") && has_value)
+        {
+            if (!integer(argv[++i], golden_options.max_bad) || golden_options.max_bad < 0)
+                return bad_value(argv[i]);
+        }
+        else if (!strcmp(argv[i], "--record") && has_value)
+            record_file = argv[++i];
+        else if (!strcmp(argv[i], "--replay") && has_value)
+        {
+            if (!Input::StartReplay(argv[++i]))
+                return 1;
+            replaying = true;
+        }
+        else if (!strcmp(argv[i], "--camera-path") && has_value)
+        {
+            if (!CameraPath::Load(argv[++i]))
+                return 1;
+            airplane.SetCamera(Airplane::scripted);
+        }
+#ifdef CS250_PROFILE
+        else if (!strcmp(argv[i], "--profile-csv") && has_value)
+            Profiler::OpenCSV(argv[++i]);
+        else if (!strcmp(argv[i], "--trace") && has_value)
+            Trace::Start(argv[++i]);
+        else if (!strcmp(argv[i], "--perf-counters"))
+            PerfCounters::Open();
+#else
+        else if (!strcmp(argv[i], "--profile-csv") || !strcmp(argv[i], "--trace") || !strcmp(argv[i], "--perf-counters"))
+        {
+            fprintf(stderr, "%s needs a build with CS250_PROFILE\n", argv[i]);
+            return 1;
+        }
+#endif
+        else
+        {
+            //The options with a value end up here too when it is missing
+            fprintf(stderr, has_value ? "Unknown option: %s\n" : "Unknown option or missing value: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+#ifdef CS250_HEADLESS
+    //Builds without SFML only render offscreen
+    if (headless_frames < 0 && !batch_poses && !golden && bench_frames <= 0)
+    {
+        fprintf(stderr, "This build has no window, use --headless, --batch, --golden or --bench\n");
+        return 1;
+    }
+#endif
+
+    //Only the keyboard of the window can be recorded, the other modes never read it
+    if (record_file)
+    {
+        if (replaying || headless_frames >= 0 || batch_poses || golden || bench_frames > 0)
+        {
+            fprintf(stderr, "--record needs the window and no --replay\n");
+            return 1;
+        }
+        Input::StartRecording(record_file);
+    }
+
+    //The benchmark starts the threads of every run itself
+    if (bench_frames > 0)
+        return Benchmark::Run(bench_frames, threads, pin_threads);
+
+    JobSystem::Init(threads, pin_threads);
+
+    if (golden)
+    {
+        golden_options.output = output;
+        int result = Golden::Run(golden_options);
+
+        JobSystem::Shutdown();
+        return result;
+    }
+
+    if (batch_poses)
+    {
+        //There is no keyboard without a window
+        Input::SetMode(Input::none);
+
+        int result = Batch::Run(airplane, batch_poses, output);
+
+        JobSystem::Shutdown();
+        return result;
+    }
+
+    if (headless_frames >= 0)
+    {
+        //There is no keyboard without a window
+        if (!replaying)
+            Input::SetMode(Input::none);
+
+        int result = Headless::Run(airplane, headless_frames, output, pipelined, frame_time);
+
+        JobSystem::Shutdown();
+        return result;
+    }
+
+#ifndef CS250_HEADLESS
     sf::RenderWindow window(sf::VideoMode(airplane.WIDTH, airplane.HEIGHT), "SFML works!");
 
-    FrameBuffer::Init(airplane.WIDTH, airplane.HEIGHT);
+    //Frames rendered ahead of the screen
+    SwapChain chain(airplane.WIDTH, airplane.HEIGHT, buffers);
 
-    // Generate image and texture to display
-    sf::Image   image;
+    // Generate pixels and texture to display
+    unsigned char * pixels = FrameBuffer::AllocateRGBA(airplane.WIDTH, airplane.HEIGHT);
     sf::Texture texture;
     sf::Sprite  sprite;
     texture.create(airplane.WIDTH, airplane.HEIGHT);
-    image.create(airplane.WIDTH, airplane.HEIGHT, sf::Color::Black);
+    sprite.setTexture(texture);
+
+    //The present thread uploads and displays the frames while the next one is rendered,
+    //the events are still handled by this thread, which created the window
+    window.setActive(false);
+    std::thread present([&]()
+    {
+        TRACE_THREAD_NAME("present");
+        window.setActive(true);
+
+        while (const FrameBuffer::Buffer * frame = chain.BeginPresent())
+        {
+            // Show image on screen
+            {
+                PROFILE_SCOPE(convert);
+                FrameBuffer::ConvertToRGBA(*frame, pixels);
+            }
+            chain.EndPresent();     //The pixels are a copy
+            {
+                PROFILE_SCOPE(upload);
+                texture.update(pixels);
+            }
+            {
+                PROFILE_SCOPE(display);
+                window.draw(sprite);
+                window.display();
+            }
+        }
+
+        window.setActive(false);
+    });
 
+    //Simulation of the next frame while this one is rendered, at the speed of the clock
+    Pipeline pipeline(airplane, pipelined, 0.0);
 
-    while (window.isOpen())
+    bool running = true;
+    while (running)
     {
-        FrameBuffer::Clear(sf::Color::White.r, sf::Color::White.g, sf::Color::White.b);
+        PROFILE_BEGIN_FRAME();
+
+        //Wait for a buffer that is not being presented
+        FrameBuffer::Bind(*chain.BeginRender());
+
+        {
+            PROFILE_SCOPE(clear);
+            FrameBuffer::Clear(sf::Color::White.r, sf::Color::White.g, sf::Color::White.b);
+        }
 
         // Handle input
         sf::Event event;
         while (window.pollEvent(event))
         {
             if (event.type == sf::Event::Closed)
-                window.close();
+                running = false;
         }
 
         if (sf::Keyboard::isKeyPressed(sf::Keyboard::Escape))
-            window.close();
+            running = false;
+
+        // Draw the airplane as it was simulated
+        airplane.Render(*pipeline.BeginFrame());
+        pipeline.EndFrame();
 
-        // Calculate airplane position
-        airplane.Airplane_Update();
+        // Stage times of the last frames
+        PROFILE_DRAW_OVERLAY();
 
-        // Show image on screen
-        FrameBuffer::ConvertFrameBufferToSFMLImage(image);
+        chain.EndRender();
 
-        texture.update(image);
-        sprite.setTexture(texture);
-        window.draw(sprite);
-        window.display();
+        PROFILE_END_FRAME();
     }
-    
-    FrameBuffer::Free();
+
+    //Present the frames left and close the window once the present thread is done with it
+    pipeline.Stop();
+    chain.Stop();
+    present.join();
+    window.close();
+    FrameBuffer::ReleaseRGBA(pixels);
+
+    Input::Finish();
+    JobSystem::Shutdown();
+#ifdef CS250_PROFILE
+    Profiler::CloseCSV();
+    Trace::Stop();
+    PerfCounters::Close();
+#endif
 
     return 2;
+#endif
 }